@@ -1,10 +1,25 @@
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+#include <sstream>
 #include <vector>
 #include <string>
 #include <queue>
 #include <climits>
 #include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <random>
+#include <unordered_map>
+#include <limits>
+#include <map>
+#include <set>
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SIMULADOR_SIMD_X86 1
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -20,29 +35,330 @@ enum AlgoritmoSubstituicao {
     OTIMO = 3
 };
 
+enum PoliticaPrefetch {
+    PREFETCH_NENHUM = 1,
+    PREFETCH_SEQUENCIAL = 2,
+    PREFETCH_STRIDE = 3
+};
+
+enum CaminhoBusca {
+    BUSCA_ESCALAR = 1,
+    BUSCA_SSE42 = 2,
+    BUSCA_AVX2 = 3,
+    BUSCA_HASH = 4
+};
+
+enum FormatoMetricas {
+    METRICAS_DESATIVADAS = 0,
+    METRICAS_CSV = 1,
+    METRICAS_JSONL = 2
+};
+
+// Tamanhos e enderecos sao guardados em bytes (64 bits); a entrada padrao continua em KB.
 struct Processo {
     string nome;
-    int tamanho;
+    long long tamanho;
+};
+
+// Pagina e bit de escrita num unico inteiro: 8 bytes por requisicao em traces longos.
+struct Referencia {
+    static const long long BIT_ESCRITA = 1LL << 62;
+    long long codigo = 0;
+
+    Referencia() = default;
+    Referencia(long long pagina, bool escrita) : codigo(pagina | (escrita ? BIT_ESCRITA : 0)) {}
+    long long pagina() const { return codigo & (BIT_ESCRITA - 1); }
+    bool escrita() const { return (codigo & BIT_ESCRITA) != 0; }
+};
+
+const long long PAGINA_MAXIMA = Referencia::BIT_ESCRITA - 1;
+
+// Custos da paginacao em microssegundos, usados no tempo efetivo de acesso.
+struct ModeloCusto {
+    double tempo_hit = 0.1;
+    double tempo_fault = 8000.0;
+    double tempo_writeback = 8000.0;
+    double tempo_prefetch = 1000.0;
 };
 
 struct Segmento {
-    int inicio;
-    int tamanho;
+    long long inicio;
+    long long tamanho;
     bool livre;
     bool fragmentacao_interna;
     bool coalescido;
     string processo;
 };
 
+// Resultado de uma requisicao de pagina; e o que o modo diferencial compara entre motores.
+struct EventoPaginacao {
+    bool hit = false;
+    int frame = -1;
+    long long removida = -1;
+    bool writeback = false;
+    int frame_prefetch = -1;
+    long long pagina_prefetch = -1;
+    long long removida_prefetch = -1;
+    bool writeback_prefetch = false;
+};
+
+// Contadores do trabalho feito nos lacos quentes (acumulados por simulacao).
+struct ContadoresInstrumentacao {
+    long long segmentos_varridos = 0;
+    long long elementos_movidos = 0;
+    long long frames_varridos = 0;
+    long long iteracoes_busca_vitima = 0;
+
+    // Cada simulacao zera so os proprios contadores: a paginacao nao apaga a serie contigua.
+    void zerar_contigua() { segmentos_varridos = 0; elementos_movidos = 0; }
+    void zerar_paginacao() { frames_varridos = 0; iteracoes_busca_vitima = 0; }
+};
+
+// Uma janela de K eventos (requisicoes de pagina ou pedidos de alocacao).
+struct JanelaMetricas {
+    string simulacao;
+    long long numero = 0;
+    long long eventos = 0;
+    long long page_faults = 0;
+    long long writebacks = 0;
+    long long falhas_alocacao = 0;
+};
+
 namespace {
     vector<Processo> g_processos_carregados;
     vector<Segmento> g_memoria;
-    int  g_tamanho_memoria_carregado = 0;
+    long long g_tamanho_memoria_carregado = 0;
     bool g_simulacao_contigua_realizada = false;
     int g_ultima_simulacao = 0; 
-    int g_page_faults = 0;      
+    long long g_page_faults = 0;
     double g_fault_rate = 0.0;  
     double g_hit_rate = 0.0;   
+    long long g_writebacks = 0;
+    double g_tempo_efetivo = 0.0;
+    ModeloCusto g_modelo_custo;
+    long long g_alinhamento = 1;
+
+    // Faixas de numero de frames para cada caminho da busca (recalibradas pelo benchmark).
+    int g_limite_simd = 16;
+    int g_limite_hash = 256;
+    int g_limite_simd_lru = 64;
+
+    FormatoMetricas g_formato_metricas = METRICAS_DESATIVADAS;
+    string g_arquivo_metricas = "metricas.csv";
+    long long g_janela_metricas = 10;
+    // Serie da alocacao contigua (opcao 1): a opcao 7 continua a numeracao no mesmo destino.
+    long long g_proxima_janela_contigua = 0;
+    FormatoMetricas g_formato_metricas_contigua = METRICAS_DESATIVADAS;
+    string g_arquivo_metricas_contigua;
+    ofstream g_saida_metricas;
+    FormatoMetricas g_formato_saida = METRICAS_DESATIVADAS;
+    string g_arquivo_saida;
+    ContadoresInstrumentacao g_contadores;
+}
+
+void iniciar_exportacao_metricas(const string& simulacao, JanelaMetricas& janela, FormatoMetricas formato,
+                                 const string& arquivo, bool anexar = false) {
+    janela = JanelaMetricas();
+    janela.simulacao = simulacao;
+    if (formato == METRICAS_DESATIVADAS || g_saida_metricas.is_open()) return;
+
+    // Ao anexar, o cabecalho so falta se o arquivo ainda nao existe ou esta vazio.
+    bool arquivo_vazio = true;
+    if (anexar) {
+        ifstream existente(arquivo, ios::binary | ios::ate);
+        arquivo_vazio = !existente || existente.tellg() <= 0;
+    }
+    g_saida_metricas.open(arquivo, ios::out | (anexar ? ios::app : ios::trunc));
+    if (!g_saida_metricas) {
+        cout << "[FALHA] Nao foi possivel abrir \"" << arquivo << "\" para exportar metricas.\n";
+        return;
+    }
+    g_formato_saida = formato;
+    g_arquivo_saida = arquivo;
+    if (formato == METRICAS_CSV && arquivo_vazio) {
+        g_saida_metricas << "simulacao,janela,eventos,page_faults,taxa_faults,frames_livres,memoria_livre,buracos,maior_buraco,"
+                            "falhas_alocacao,segmentos_varridos,elementos_movidos,frames_varridos,iteracoes_busca_vitima,writebacks\n";
+    }
+}
+
+// Colunas que nao se aplicam a simulacao da janela (argumentos negativos, contadores e eventos
+// da outra simulacao) saem como campo vazio no CSV e null no JSON.
+void fechar_janela_metricas(JanelaMetricas& janela, long long frames_livres, long long memoria_livre,
+                            long long buracos, long long maior_buraco) {
+    if (janela.eventos == 0) return;
+    if (g_saida_metricas.is_open()) {
+        const bool paginacao = janela.simulacao == "paginacao";
+        const auto& c = g_contadores;
+        auto opcional = [](long long valor) { return valor < 0 ? string() : to_string(valor); };
+        auto de_paginacao = [&](long long valor) { return paginacao ? to_string(valor) : string(); };
+        auto de_contigua = [&](long long valor) { return paginacao ? string() : to_string(valor); };
+        ostringstream taxa_faults;
+        if (paginacao) {
+            taxa_faults << fixed << setprecision(2) << static_cast<double>(janela.page_faults) / janela.eventos * 100.0;
+        }
+        const pair<const char*, string> colunas[] = {
+            {"janela", to_string(janela.numero)},
+            {"eventos", to_string(janela.eventos)},
+            {"page_faults", de_paginacao(janela.page_faults)},
+            {"taxa_faults", taxa_faults.str()},
+            {"frames_livres", opcional(frames_livres)},
+            {"memoria_livre", opcional(memoria_livre)},
+            {"buracos", opcional(buracos)},
+            {"maior_buraco", opcional(maior_buraco)},
+            {"falhas_alocacao", de_contigua(janela.falhas_alocacao)},
+            {"segmentos_varridos", de_contigua(c.segmentos_varridos)},
+            {"elementos_movidos", de_contigua(c.elementos_movidos)},
+            {"frames_varridos", de_paginacao(c.frames_varridos)},
+            {"iteracoes_busca_vitima", de_paginacao(c.iteracoes_busca_vitima)},
+            {"writebacks", de_paginacao(janela.writebacks)},
+        };
+        if (g_formato_saida == METRICAS_CSV) {
+            g_saida_metricas << janela.simulacao;
+            for (const auto& coluna : colunas) g_saida_metricas << ',' << coluna.second;
+            g_saida_metricas << '\n';
+        } else {
+            g_saida_metricas << "{\"simulacao\":\"" << janela.simulacao << '"';
+            for (const auto& coluna : colunas) {
+                g_saida_metricas << ",\"" << coluna.first << "\":" << (coluna.second.empty() ? "null" : coluna.second);
+            }
+            g_saida_metricas << "}\n";
+        }
+    }
+    janela.numero++;
+    janela.eventos = 0;
+    janela.page_faults = 0;
+    janela.writebacks = 0;
+    janela.falhas_alocacao = 0;
+}
+
+void fechar_janela_memoria(JanelaMetricas& janela, const vector<Segmento>& memoria) {
+    long long livre = 0, maior = 0, buracos = 0;
+    for (const auto& b : memoria) {
+        if (!b.livre) continue;
+        buracos++;
+        livre += b.tamanho;
+        if (b.tamanho > maior) maior = b.tamanho;
+    }
+    fechar_janela_metricas(janela, -1, livre, buracos, maior);
+}
+
+void finalizar_exportacao_metricas() {
+    if (!g_saida_metricas.is_open()) return;
+    g_saida_metricas.close();
+    cout << "[OK] Metricas exportadas para \"" << g_arquivo_saida << "\".\n";
+}
+
+void configurar_exportacao_metricas() {
+    int op;
+    while (true) {
+        cout << "\nFormato da serie temporal de metricas:\n";
+        cout << "0 - Desativada\n";
+        cout << "1 - CSV\n";
+        cout << "2 - JSON Lines\n";
+        cout << "Opcao: ";
+        cin >> op;
+        if (cin.fail() || op < 0 || op > 2) {
+            cin.clear();
+            cin.ignore(1000, '\n');
+            cout << "Opcao invalida!\n";
+            continue;
+        }
+        break;
+    }
+    g_formato_metricas = (FormatoMetricas)op;
+    if (g_formato_metricas == METRICAS_DESATIVADAS) {
+        cout << "[OK] Exportacao de metricas desativada.\n";
+        return;
+    }
+
+    cout << "Arquivo de saida: ";
+    cin >> g_arquivo_metricas;
+    while (true) {
+        cout << "Tamanho da janela (K eventos): ";
+        cin >> g_janela_metricas;
+        if (cin.fail() || g_janela_metricas <= 0) {
+            cin.clear();
+            cin.ignore(1000, '\n');
+            cout << "Valor invalido!\n";
+            continue;
+        }
+        break;
+    }
+    cout << "[OK] Metricas serao exportadas em " << (g_formato_metricas == METRICAS_CSV ? "CSV" : "JSON Lines")
+         << " para \"" << g_arquivo_metricas << "\" a cada " << g_janela_metricas << " eventos.\n";
+}
+
+// Aceita um numero com sufixo opcional B, K, M, G ou T (sem sufixo = KB).
+bool interpretar_tamanho(const string& token, long long& bytes) {
+    size_t i = 0;
+    while (i < token.size() && isdigit((unsigned char)token[i])) i++;
+    if (i == 0 || i > 18) return false;
+    long long valor = stoll(token.substr(0, i));
+    string sufixo = token.substr(i);
+    for (auto& c : sufixo) c = (char)toupper((unsigned char)c);
+    if (sufixo.size() == 2 && sufixo[1] == 'B' && sufixo[0] != 'B') sufixo.pop_back();
+
+    long long escala;
+    if (sufixo == "B") escala = 1;
+    else if (sufixo.empty() || sufixo == "K") escala = 1LL << 10;
+    else if (sufixo == "M") escala = 1LL << 20;
+    else if (sufixo == "G") escala = 1LL << 30;
+    else if (sufixo == "T") escala = 1LL << 40;
+    else return false;
+
+    if (valor > LLONG_MAX / escala) return false;
+    bytes = valor * escala;
+    return true;
+}
+
+long long ler_tamanho(const string& rotulo) {
+    while (true) {
+        cout << rotulo << " (KB, ou com sufixo B/K/M/G/T): ";
+        string token;
+        cin >> token;
+        long long bytes;
+        if (cin.fail() || !interpretar_tamanho(token, bytes) || bytes <= 0) {
+            cin.clear();
+            cout << "Valor invalido!\n";
+            continue;
+        }
+        return bytes;
+    }
+}
+
+string formatar_tamanho(long long bytes) {
+    if (bytes % 1024 == 0) return to_string(bytes / 1024) + " KB";
+    return to_string(bytes) + " B";
+}
+
+string formatar_endereco(long long bytes) {
+    if (bytes % 1024 == 0) return to_string(bytes / 1024);
+    return to_string(bytes) + "B";
+}
+
+// Devolve -1 quando o valor arredondado nao cabe em 64 bits.
+long long alinhar_acima(long long valor, long long alinhamento) {
+    if (valor > LLONG_MAX - (alinhamento - 1)) return -1;
+    return (valor + alinhamento - 1) / alinhamento * alinhamento;
+}
+
+void configurar_alinhamento() {
+    long long valor;
+    while (true) {
+        cout << "Alinhamento das alocacoes em bytes (potencia de 2, 1 = sem restricao) [atual "
+             << g_alinhamento << "]: ";
+        cin >> valor;
+        if (cin.fail() || valor <= 0 || (valor & (valor - 1)) != 0 || valor > (1LL << 40)) {
+            cin.clear();
+            cin.ignore(1000, '\n');
+            cout << "Valor invalido!\n";
+            continue;
+        }
+        break;
+    }
+    g_alinhamento = valor;
+    cout << "[OK] Processos serao alocados em enderecos multiplos de " << g_alinhamento
+         << " bytes, com tamanho arredondado para o mesmo multiplo.\n";
 }
 
 vector<Processo> ler_processos() {
@@ -64,17 +380,7 @@ vector<Processo> ler_processos() {
         Processo p;
         cout << "Nome do processo " << (i + 1) << ": ";
         cin >> p.nome;
-        while (true) {
-            cout << "Tamanho (KB): ";
-            cin >> p.tamanho;
-            if (cin.fail() || p.tamanho <= 0) {
-                cin.clear();
-                cin.ignore(1000, '\n');
-                cout << "Valor invalido!\n";
-                continue;
-            }
-            break;
-        }
+        p.tamanho = ler_tamanho("Tamanho");
         lista.push_back(p);
     }
     return lista;
@@ -100,15 +406,22 @@ Estrategia escolher_estrategia() {
     }
 }
 
-int escolher_segmento(const vector<Segmento>& memoria, int tamanho, Estrategia estrategia) {
+// Escolha linear original, mantida como referencia do IndiceBuracos no modo diferencial.
+// O tamanho ja vem arredondado ao alinhamento; o bloco precisa caber a partir do primeiro endereco alinhado.
+int escolher_segmento(const vector<Segmento>& memoria, long long tamanho, Estrategia estrategia) {
     int indice_escolhido = -1;
-    int melhor_sobra = 0;
+    long long melhor_sobra = 0;
 
     for (size_t i = 0; i < memoria.size(); i++) {
+        g_contadores.segmentos_varridos++;
         const auto& bloco = memoria[i];
-        if (!bloco.livre || bloco.tamanho < tamanho) continue;
+        if (!bloco.livre) continue;
+        long long alinhado = alinhar_acima(bloco.inicio, g_alinhamento);
+        if (alinhado == -1) continue;
+        long long deslocamento = alinhado - bloco.inicio;
+        if (bloco.tamanho - deslocamento < tamanho) continue;
 
-        int sobra = bloco.tamanho - tamanho;
+        long long sobra = bloco.tamanho - deslocamento - tamanho;
 
         if (estrategia == FIRST_FIT) return (int)i;
 
@@ -133,6 +446,90 @@ int escolher_segmento(const vector<Segmento>& memoria, int tamanho, Estrategia e
     return indice_escolhido;
 }
 
+// Indice dos buracos livres por tamanho e por endereco, usado pela alocacao contigua.
+// Escolhe o mesmo buraco que escolher_segmento (inclusive desempates) sem varrer os
+// blocos ocupados; ocupar, liberar e coalescer o atualizam buraco a buraco.
+struct IndiceBuracos {
+    set<pair<long long, long long>> por_tamanho;
+    map<long long, long long> por_inicio;
+
+    void reconstruir(const vector<Segmento>& memoria) {
+        por_tamanho.clear();
+        por_inicio.clear();
+        for (const auto& b : memoria) {
+            if (b.livre) inserir(b.inicio, b.tamanho);
+        }
+    }
+
+    void inserir(long long inicio, long long tamanho) {
+        por_tamanho.insert({tamanho, inicio});
+        por_inicio[inicio] = tamanho;
+    }
+
+    void remover(long long inicio, long long tamanho) {
+        por_tamanho.erase({tamanho, inicio});
+        por_inicio.erase(inicio);
+    }
+
+    // Dois buracos sao adjacentes quando um termina onde o outro comeca.
+    bool existe_adjacentes() const {
+        long long fim_anterior = -1;
+        for (const auto& b : por_inicio) {
+            if (b.first == fim_anterior) return true;
+            fim_anterior = b.first + b.second;
+        }
+        return false;
+    }
+
+    // Devolve o inicio do buraco escolhido, ou -1.
+    long long escolher(long long tamanho, Estrategia estrategia) const {
+        const long long folga_maxima = g_alinhamento - 1;
+        long long escolhido = -1, melhor_sobra = 0;
+
+        auto avaliar = [&](long long inicio, long long tam_bloco) {
+            g_contadores.segmentos_varridos++;
+            long long alinhado = alinhar_acima(inicio, g_alinhamento);
+            if (alinhado == -1) return false;
+            long long deslocamento = alinhado - inicio;
+            if (tam_bloco - deslocamento < tamanho) return false;
+            long long sobra = tam_bloco - deslocamento - tamanho;
+            bool melhor = escolhido == -1
+                || (estrategia == BEST_FIT && sobra < melhor_sobra)
+                || (estrategia == WORST_FIT && sobra > melhor_sobra)
+                || (sobra == melhor_sobra && inicio < escolhido);
+            if (melhor) {
+                escolhido = inicio;
+                melhor_sobra = sobra;
+            }
+            return true;
+        };
+
+        if (estrategia == FIRST_FIT) {
+            for (const auto& b : por_inicio) {
+                if (avaliar(b.first, b.second)) return b.first;
+            }
+        } else if (estrategia == BEST_FIT) {
+            // A sobra de um bloco de tamanho t fica entre t - tamanho - folga e t - tamanho.
+            for (auto it = por_tamanho.lower_bound({tamanho, LLONG_MIN}); it != por_tamanho.end(); ++it) {
+                if (escolhido != -1 && it->first - tamanho - folga_maxima > melhor_sobra) break;
+                avaliar(it->second, it->first);
+            }
+        } else {
+            for (auto it = por_tamanho.rbegin(); it != por_tamanho.rend(); ++it) {
+                if (it->first < tamanho) break;
+                if (escolhido != -1 && it->first - tamanho < melhor_sobra) break;
+                avaliar(it->second, it->first);
+            }
+        }
+        return escolhido;
+    }
+};
+
+namespace {
+    // Buracos de g_memoria; toda rotina que altera g_memoria atualiza o indice junto.
+    IndiceBuracos g_buracos;
+}
+
 bool existe_buracos_adjacentes(const vector<Segmento>& memoria) {
     for (size_t i = 0; i + 1 < memoria.size(); i++) {
         if (memoria[i].livre && memoria[i+1].livre) return true;
@@ -140,7 +537,7 @@ bool existe_buracos_adjacentes(const vector<Segmento>& memoria) {
     return false;
 }
 
-bool coalescer_buracos(vector<Segmento>& memoria) {
+bool coalescer_buracos(vector<Segmento>& memoria, IndiceBuracos* buracos = nullptr) {
     vector<Segmento> nova;
     nova.reserve(memoria.size());
     bool houve_coalescencia_global = false;
@@ -151,8 +548,8 @@ bool coalescer_buracos(vector<Segmento>& memoria) {
             i++;
             continue;
         }
-        int inicio = memoria[i].inicio;
-        int soma = memoria[i].tamanho;
+        long long inicio = memoria[i].inicio;
+        long long soma = memoria[i].tamanho;
         bool coalesceu = false;
         size_t j = i + 1;
         while (j < memoria.size() && memoria[j].livre) {
@@ -160,6 +557,10 @@ bool coalescer_buracos(vector<Segmento>& memoria) {
             coalesceu = true;
             j++;
         }
+        if (coalesceu && buracos) {
+            for (size_t k = i; k < j; k++) buracos->remover(memoria[k].inicio, memoria[k].tamanho);
+            buracos->inserir(inicio, soma);
+        }
         Segmento merged;
         merged.inicio = inicio;
         merged.tamanho = soma;
@@ -171,6 +572,7 @@ bool coalescer_buracos(vector<Segmento>& memoria) {
         if (coalesceu) houve_coalescencia_global = true;
         i = j;
     }
+    g_contadores.elementos_movidos += (long long)nova.size();
     memoria.swap(nova);
     return houve_coalescencia_global;
 }
@@ -182,9 +584,20 @@ void compactar_memoria() {
     }
     vector<Segmento> nova;
     nova.reserve(g_memoria.size());
-    int endereco = 0;
+    long long endereco = 0;
     for (const auto& b : g_memoria) {
         if (!b.livre) {
+            // O alinhamento pode ter aumentado desde a alocacao; o layout precisa caber na memoria.
+            long long alinhado = alinhar_acima(endereco, g_alinhamento);
+            if (alinhado == -1 || b.tamanho > g_tamanho_memoria_carregado - alinhado) {
+                cout << "[FALHA] Com alinhamento de " << g_alinhamento << " bytes os processos nao cabem na memoria "
+                     << "compactada. Memoria mantida como estava; reduza o alinhamento (opcao 11) ou libere processos.\n";
+                return;
+            }
+            if (alinhado > endereco) {
+                nova.push_back({endereco, alinhado - endereco, true, false, false, ""});
+                endereco = alinhado;
+            }
             Segmento x;
             x.inicio = endereco;
             x.tamanho = b.tamanho;
@@ -196,19 +609,19 @@ void compactar_memoria() {
             endereco += b.tamanho;
         }
     }
-    int livre_total = 0;
-    for (const auto& b : g_memoria) if (b.livre) livre_total += b.tamanho;
-    if (livre_total > 0) {
+    if (endereco < g_tamanho_memoria_carregado) {
         Segmento livre;
         livre.inicio = endereco;
-        livre.tamanho = livre_total;
+        livre.tamanho = g_tamanho_memoria_carregado - endereco;
         livre.livre = true;
         livre.fragmentacao_interna = false;
         livre.coalescido = true;
         livre.processo = "";
         nova.push_back(livre);
     }
+    g_contadores.elementos_movidos += (long long)nova.size();
     g_memoria.swap(nova);
+    g_buracos.reconstruir(g_memoria);
     cout << "[OK] Compactacao executada.\n";
 }
 
@@ -217,20 +630,20 @@ void imprimir_mapa_e_estatisticas(const vector<Segmento>& memoria, bool mostrar_
         cout << "\n===== Mapa da Memoria =====\n";
         for (const auto& bloco : memoria) {
             if (bloco.livre) {
-                cout << "Endereco " << setw(5) << bloco.inicio << " | "
-                     << setw(6) << bloco.tamanho << " KB | LIVRE";
+                cout << right << "Endereco " << setw(5) << formatar_endereco(bloco.inicio) << " | "
+                     << setw(9) << formatar_tamanho(bloco.tamanho) << " | LIVRE";
                 if (bloco.fragmentacao_interna) cout << " (FRAGMENTACAO INTERNA)";
                 if (bloco.coalescido)          cout << " (COALESCIDO)";
                 cout << "\n";
             } else {
-                cout << "Endereco " << setw(5) << bloco.inicio << " | "
-                     << setw(6) << bloco.tamanho << " KB | Processo: " << bloco.processo << "\n";
+                cout << right << "Endereco " << setw(5) << formatar_endereco(bloco.inicio) << " | "
+                     << setw(9) << formatar_tamanho(bloco.tamanho) << " | Processo: " << bloco.processo << "\n";
             }
         }
         cout << "===========================\n";
 
         if (mostrar_estatisticas) {
-            int buracos = 0, soma_buracos = 0, frag_interna = 0;
+            long long buracos = 0, soma_buracos = 0, frag_interna = 0;
             for (const auto& b : memoria) {
                 if (b.livre) {
                     buracos++;
@@ -239,39 +652,50 @@ void imprimir_mapa_e_estatisticas(const vector<Segmento>& memoria, bool mostrar_
                 }
             }
             cout << "Estatisticas:\n";
-            cout << " - Buracos livres: " << buracos << " | Total livre: " << soma_buracos << " KB\n";
-            cout << " - Fragmentacao interna (somas marcadas): " << frag_interna << " KB\n\n";
+            cout << " - Buracos livres: " << buracos << " | Total livre: " << formatar_tamanho(soma_buracos) << "\n";
+            cout << " - Fragmentacao interna (somas marcadas): " << formatar_tamanho(frag_interna) << "\n";
+            cout << " - Instrumentacao: " << g_contadores.segmentos_varridos << " segmentos varridos | "
+                 << g_contadores.elementos_movidos << " elementos movidos\n\n";
         }
     } else if (g_ultima_simulacao == 2) {
         cout << "\n===== Metricas da Ultima Simulacao de Paginacao =====\n";
         cout << "Total de page faults: " << g_page_faults << "\n";
         cout << "Taxa de page faults: " << fixed << setprecision(2) << g_fault_rate << "%\n";
         cout << "Taxa de acertos: " << fixed << setprecision(2) << g_hit_rate << "%\n";
+        cout << "Write-backs: " << g_writebacks << "\n";
+        cout << "Tempo efetivo de acesso: " << fixed << setprecision(2) << g_tempo_efetivo << " us\n";
+        cout << "Instrumentacao: " << g_contadores.frames_varridos << " frames varridos | "
+             << g_contadores.iteracoes_busca_vitima << " iteracoes na busca de vitima\n";
     } else {
         cout << "Nenhuma simulação realizada ainda.\n";
     }
 }
 
-bool liberar_processo_por_nome(const string& nome) {
+bool liberar_processo(vector<Segmento>& memoria, const string& nome, IndiceBuracos* buracos = nullptr) {
     bool achou = false;
-    for (auto& b : g_memoria) {
+    for (auto& b : memoria) {
         if (!b.livre && b.processo == nome) {
             b.livre = true;
             b.processo = "";
             b.fragmentacao_interna = false;
             b.coalescido = false;
+            if (buracos) buracos->inserir(b.inicio, b.tamanho);
             achou = true;
         }
     }
-    if (!achou) return false;
-    coalescer_buracos(g_memoria);
+    if (achou) coalescer_buracos(memoria, buracos);
+    return achou;
+}
+
+bool liberar_processo_por_nome(const string& nome) {
+    if (!liberar_processo(g_memoria, nome, &g_buracos)) return false;
     cout << "[OK] Processo \"" << nome << "\" liberado e buracos coalescidos (se possivel).\n";
     return true;
 }
 
 auto esperar_passo = []() {
     while (true) {
-        cout << "Digite 1 para proximo passo ou 0 para interromper: ";
+        cout << "Digite 1 para proximo passo, 2 para executar ate o fim ou 0 para interromper: ";
         cout.flush();
         string entrada;
         cin >> entrada;
@@ -279,10 +703,99 @@ auto esperar_passo = []() {
         cout.flush();
         if (entrada == "0") return 0;
         if (entrada == "1") return 1;
-        cout << "Entrada invalida! Digite 1 ou 0.\n";
+        if (entrada == "2") return 2;
+        cout << "Entrada invalida! Digite 1, 2 ou 0.\n";
     }
 };
 
+// Coloca o processo no buraco escolhido e devolve o indice do bloco alocado.
+int ocupar_segmento(vector<Segmento>& memoria, int indice, const string& nome, long long tamanho,
+                    IndiceBuracos* buracos = nullptr) {
+    if (buracos) buracos->remover(memoria[indice].inicio, memoria[indice].tamanho);
+    long long deslocamento = alinhar_acima(memoria[indice].inicio, g_alinhamento) - memoria[indice].inicio;
+    if (deslocamento > 0) {
+        // O inicio desalinhado do bloco vira um buraco proprio antes do processo.
+        Segmento bloco_alinhado = memoria[indice];
+        bloco_alinhado.inicio += deslocamento;
+        bloco_alinhado.tamanho -= deslocamento;
+        memoria[indice].tamanho = deslocamento;
+        if (buracos) buracos->inserir(memoria[indice].inicio, deslocamento);
+        g_contadores.elementos_movidos += (long long)(memoria.size() - (indice + 1));
+        memoria.insert(memoria.begin() + (indice + 1), bloco_alinhado);
+        indice++;
+    }
+
+    auto& bloco = memoria[indice];
+    long long sobra = bloco.tamanho - tamanho;
+    bloco.livre = false;
+    bloco.processo = nome;
+    bloco.tamanho = tamanho;
+
+    if (sobra > 0) {
+        Segmento novo_bloco{ bloco.inicio + tamanho, sobra, true, true, false, "" };
+        if (buracos) buracos->inserir(novo_bloco.inicio, sobra);
+        g_contadores.elementos_movidos += (long long)(memoria.size() - (indice + 1));
+        memoria.insert(memoria.begin() + (indice + 1), novo_bloco);
+    }
+    return indice;
+}
+
+// Escolhe o buraco pelo indice e ocupa; se nada couber e houver buracos adjacentes,
+// coalesce e tenta de novo. Devolve o indice do bloco alocado, ou -1.
+int alocar_em_buraco(vector<Segmento>& memoria, IndiceBuracos& buracos, const string& nome, long long tamanho,
+                     Estrategia estrategia, bool& coalesceu) {
+    auto ocupar_escolhido = [&]() {
+        long long inicio = buracos.escolher(tamanho, estrategia);
+        if (inicio == -1) return -1;
+        auto it = lower_bound(memoria.begin(), memoria.end(), inicio,
+                              [](const Segmento& b, long long pos) { return b.inicio < pos; });
+        return ocupar_segmento(memoria, (int)(it - memoria.begin()), nome, tamanho, &buracos);
+    };
+
+    coalesceu = false;
+    int indice = ocupar_escolhido();
+    if (indice == -1 && buracos.existe_adjacentes()) {
+        coalescer_buracos(memoria, &buracos);
+        coalesceu = true;
+        indice = ocupar_escolhido();
+    }
+    return indice;
+}
+
+bool alocar_processo(const Processo& processo, Estrategia estrategia) {
+    long long tamanho = alinhar_acima(processo.tamanho, g_alinhamento);
+    if (tamanho == -1) {
+        cout << "[FALHA] Processo " << processo.nome << " (" << formatar_tamanho(processo.tamanho)
+             << ") excede o maior tamanho representavel com alinhamento de " << g_alinhamento << " bytes.\n";
+        return false;
+    }
+
+    bool coalesceu;
+    int indice = alocar_em_buraco(g_memoria, g_buracos, processo.nome, tamanho, estrategia, coalesceu);
+    if (coalesceu) {
+        cout << "[INFO] Coalescendo buracos livres adjacentes para tentar alocar "
+             << processo.nome << " (" << formatar_tamanho(processo.tamanho) << ")...\n";
+    }
+
+    if (indice == -1) {
+        if (coalesceu) {
+            cout << "[FALHA] Ainda nao foi possivel alocar " << processo.nome
+                 << ". Considere: compactar memoria, liberar processos, mudar estrategia, reordenar carga, paginacao/swapping, aumentar memoria.\n";
+        } else {
+            cout << "[FALHA] Processo " << processo.nome << " (" << formatar_tamanho(processo.tamanho)
+                 << ") nao cabe em nenhum espaco livre.\n";
+            cout << "Sugestoes: compactar; coalescer; liberar processos; mudar estrategia; reordenar; paginacao/swapping; aumentar memoria.\n";
+        }
+        return false;
+    }
+
+    cout << "[OK] Alocando processo " << processo.nome << " (" << formatar_tamanho(processo.tamanho)
+         << ") no endereco " << formatar_endereco(g_memoria[indice].inicio) << " usando "
+         << (estrategia == FIRST_FIT ? "First Fit" : (estrategia == BEST_FIT ? "Best Fit" : "Worst Fit"))
+         << ".\n";
+    return true;
+}
+
 void simular_alocacao_contigua() {
     g_memoria.clear();
     int q;
@@ -297,23 +810,18 @@ void simular_alocacao_contigua() {
         }
         break;
     }
-    int endereco_atual = 0;
+    long long endereco_atual = 0;
     for (int i = 0; i < q; i++) {
-        int tam;
-        while (true) {
-            cout << "Tamanho do espaco livre " << (i + 1) << " (KB): ";
-            cin >> tam;
-            if (cin.fail() || tam <= 0) {
-                cin.clear();
-                cin.ignore(1000, '\n');
-                cout << "Valor invalido!\n";
-                continue;
-            }
-            break;
+        long long tam = ler_tamanho("Tamanho do espaco livre " + to_string(i + 1));
+        if (tam > LLONG_MAX - endereco_atual) {
+            cout << "Valor invalido!\n";
+            i--;
+            continue;
         }
         g_memoria.push_back({endereco_atual, tam, true, false, false, ""});
         endereco_atual += tam;
     }
+    g_buracos.reconstruir(g_memoria);
 
     vector<Processo> processos = ler_processos();
     Estrategia estrategia = escolher_estrategia();
@@ -322,55 +830,32 @@ void simular_alocacao_contigua() {
     g_tamanho_memoria_carregado = endereco_atual;
     g_simulacao_contigua_realizada = true;
     g_ultima_simulacao = 1; 
+    g_contadores.zerar_contigua();
+    g_formato_metricas_contigua = g_formato_metricas;
+    g_arquivo_metricas_contigua = g_arquivo_metricas;
+
+    JanelaMetricas janela;
+    iniciar_exportacao_metricas("contigua", janela, g_formato_metricas_contigua, g_arquivo_metricas_contigua);
 
     cout << "\n===== Iniciando simulacao de alocacao contigua =====\n";
 
+    bool continuo = false;
     for (const auto& processo : processos) {
-        int passo = esperar_passo();
+        int passo = continuo ? 1 : esperar_passo();
+        if (passo == 2) continuo = true;
         if (passo == 0) {
             cout << "\nSimulacao interrompida pelo usuario.\n";
-            imprimir_mapa_e_estatisticas(g_memoria, true);
-            return;
-        }
-
-        int indice = escolher_segmento(g_memoria, processo.tamanho, estrategia);
-
-        if (indice == -1) {
-            if (existe_buracos_adjacentes(g_memoria)) {
-                cout << "[INFO] Coalescendo buracos livres adjacentes para tentar alocar "
-                     << processo.nome << " (" << processo.tamanho << " KB)...\n";
-                coalescer_buracos(g_memoria);
-                indice = escolher_segmento(g_memoria, processo.tamanho, estrategia);
-                if (indice == -1) {
-                    cout << "[FALHA] Ainda nao foi possivel alocar " << processo.nome
-                         << ". Considere: compactar memoria, liberar processos, mudar estrategia, reordenar carga, paginacao/swapping, aumentar memoria.\n";
-                    continue;
-                }
-            } else {
-                cout << "[FALHA] Processo " << processo.nome << " (" << processo.tamanho
-                     << " KB) nao cabe em nenhum espaco livre.\n";
-                cout << "Sugestoes: compactar; coalescer; liberar processos; mudar estrategia; reordenar; paginacao/swapping; aumentar memoria.\n";
-                continue;
-            }
+            break;
         }
 
-        auto& bloco = g_memoria[indice];
-        int sobra = bloco.tamanho - processo.tamanho;
-
-        cout << "[OK] Alocando processo " << processo.nome << " (" << processo.tamanho
-             << " KB) no endereco " << bloco.inicio << " usando "
-             << (estrategia == FIRST_FIT ? "First Fit" : (estrategia == BEST_FIT ? "Best Fit" : "Worst Fit"))
-             << ".\n";
-
-        bloco.livre = false;
-        bloco.processo = processo.nome;
-        bloco.tamanho = processo.tamanho;
-
-        if (sobra > 0) {
-            Segmento novo_bloco{ bloco.inicio + processo.tamanho, sobra, true, true, false, "" };
-            g_memoria.insert(g_memoria.begin() + (indice + 1), novo_bloco);
-        }
+        bool alocado = alocar_processo(processo, estrategia);
+        janela.eventos++;
+        if (!alocado) janela.falhas_alocacao++;
+        if (janela.eventos == g_janela_metricas) fechar_janela_memoria(janela, g_memoria);
     }
+    fechar_janela_memoria(janela, g_memoria);
+    g_proxima_janela_contigua = janela.numero;
+    finalizar_exportacao_metricas();
 
     imprimir_mapa_e_estatisticas(g_memoria, true);
 }
@@ -386,62 +871,115 @@ void adicionar_processos_contigua() {
 
     g_processos_carregados.insert(g_processos_carregados.end(), novos_processos.begin(), novos_processos.end());
 
+    JanelaMetricas janela;
+    iniciar_exportacao_metricas("contigua", janela, g_formato_metricas_contigua, g_arquivo_metricas_contigua, true);
+    janela.numero = g_proxima_janela_contigua;
+
     cout << "\n===== Adicionando processos a simulacao contigua =====\n";
 
+    bool continuo = false;
     for (const auto& processo : novos_processos) {
-        int passo = esperar_passo();
+        int passo = continuo ? 1 : esperar_passo();
+        if (passo == 2) continuo = true;
         if (passo == 0) {
             cout << "\nAdicao de processos interrompida pelo usuario.\n";
-            imprimir_mapa_e_estatisticas(g_memoria, true);
-            return;
+            break;
         }
 
-        int indice = escolher_segmento(g_memoria, processo.tamanho, estrategia);
-
-        if (indice == -1) {
-            if (existe_buracos_adjacentes(g_memoria)) {
-                cout << "[INFO] Coalescendo buracos livres adjacentes para tentar alocar "
-                     << processo.nome << " (" << processo.tamanho << " KB)...\n";
-                coalescer_buracos(g_memoria);
-                indice = escolher_segmento(g_memoria, processo.tamanho, estrategia);
-                if (indice == -1) {
-                    cout << "[FALHA] Ainda nao foi possivel alocar " << processo.nome
-                         << ". Considere: compactar memoria, liberar processos, mudar estrategia, reordenar carga, paginacao/swapping, aumentar memoria.\n";
-                    continue;
-                }
-            } else {
-                cout << "[FALHA] Processo " << processo.nome << " (" << processo.tamanho
-                     << " KB) nao cabe em nenhum espaco livre.\n";
-                cout << "Sugestoes: compactar; coalescer; liberar processos; mudar estrategia; reordenar; paginacao/swapping; aumentar memoria.\n";
-                continue;
-            }
-        }
+        bool alocado = alocar_processo(processo, estrategia);
+        janela.eventos++;
+        if (!alocado) janela.falhas_alocacao++;
+        if (janela.eventos == g_janela_metricas) fechar_janela_memoria(janela, g_memoria);
+    }
+    fechar_janela_memoria(janela, g_memoria);
+    g_proxima_janela_contigua = janela.numero;
+    finalizar_exportacao_metricas();
 
-        auto& bloco = g_memoria[indice];
-        int sobra = bloco.tamanho - processo.tamanho;
+    imprimir_mapa_e_estatisticas(g_memoria, true);
+}
 
-        cout << "[OK] Alocando processo " << processo.nome << " (" << processo.tamanho
-             << " KB) no endereco " << bloco.inicio << " usando "
-             << (estrategia == FIRST_FIT ? "First Fit" : (estrategia == BEST_FIT ? "Best Fit" : "Worst Fit"))
-             << ".\n";
+bool interpretar_referencia(const string& token, Referencia& ref) {
+    size_t i = 0;
+    while (i < token.size() && isdigit((unsigned char)token[i])) i++;
+    // Ate 18 digitos, sempre abaixo de PAGINA_MAXIMA.
+    if (i == 0 || i > 18) return false;
+    long long pagina = stoll(token.substr(0, i));
+    bool escrita = false;
+    if (i + 1 == token.size()) {
+        char op = (char)toupper((unsigned char)token[i]);
+        if (op == 'W') escrita = true;
+        else if (op != 'R') return false;
+    } else if (i != token.size()) {
+        return false;
+    }
+    ref = Referencia(pagina, escrita);
+    return true;
+}
 
-        bloco.livre = false;
-        bloco.processo = processo.nome;
-        bloco.tamanho = processo.tamanho;
+string rotulo_referencia(const Referencia& ref) {
+    return to_string(ref.pagina()) + (ref.escrita() ? "W" : "");
+}
 
-        if (sobra > 0) {
-            Segmento novo_bloco{ bloco.inicio + processo.tamanho, sobra, true, true, false, "" };
-            g_memoria.insert(g_memoria.begin() + (indice + 1), novo_bloco);
+long long ler_inteiro(const string& rotulo, long long minimo, long long maximo) {
+    long long valor;
+    while (true) {
+        cout << rotulo << ": ";
+        cin >> valor;
+        if (cin.fail() || valor < minimo || valor > maximo) {
+            cin.clear();
+            cin.ignore(1000, '\n');
+            cout << "Valor invalido!\n";
+            continue;
         }
+        return valor;
     }
+}
 
-    imprimir_mapa_e_estatisticas(g_memoria, true);
+// Sequencia uniforme em [pagina inicial, pagina inicial + distintas), gerada sob demanda
+// para que traces longos nao precisem ficar inteiros na memoria.
+struct GeradorRequisicoes {
+    long long quantidade = 0;
+    long long distintas = 1;
+    long long base = 0;
+    long long pct_escrita = 0;
+    mt19937_64 gerador;
+
+    Referencia proxima() {
+        long long pagina = base + (long long)(gerador() % (unsigned long long)distintas);
+        bool escrita = (long long)(gerador() % 100) < pct_escrita;
+        return Referencia(pagina, escrita);
+    }
+};
+
+// Requisicoes digitadas (em memoria) ou sinteticas (geradas na hora, salvo se materializadas).
+struct FonteRequisicoes {
+    vector<Referencia> lista;
+    bool sintetica = false;
+    GeradorRequisicoes sintetico;
+
+    long long total() const { return sintetica ? sintetico.quantidade : (long long)lista.size(); }
+};
+
+// Gera a sequencia sintetica inteira em lista (o Otimo e o modo diferencial precisam dela).
+bool materializar_requisicoes(FonteRequisicoes& fonte) {
+    if (!fonte.sintetica) return true;
+    try {
+        fonte.lista.resize((size_t)fonte.sintetico.quantidade);
+    } catch (const exception&) {
+        cout << "[FALHA] Memoria insuficiente para guardar " << fonte.sintetico.quantidade << " requisicoes.\n";
+        return false;
+    }
+    GeradorRequisicoes gerador = fonte.sintetico;
+    for (auto& ref : fonte.lista) ref = gerador.proxima();
+    fonte.sintetica = false;
+    return true;
 }
 
-vector<int> ler_requisicoes() {
-    int n;
+FonteRequisicoes ler_requisicoes() {
+    FonteRequisicoes fonte;
+    long long n;
     while (true) {
-        cout << "Quantas requisicoes de paginas deseja inserir? ";
+        cout << "Quantas requisicoes de paginas deseja inserir? (0 = gerar sequencia sintetica) ";
         cin >> n;
         if (cin.fail() || n < 0) {
             cin.clear();
@@ -449,24 +987,43 @@ vector<int> ler_requisicoes() {
             cout << "Valor invalido!\n";
             continue;
         }
+        if (n == 0) break;
+        try {
+            fonte.lista.resize((size_t)n);
+        } catch (const exception&) {
+            cout << "[FALHA] Memoria insuficiente para " << n << " requisicoes.\n";
+            continue;
+        }
         break;
     }
 
-    vector<int> lista(n);
-    for (int i = 0; i < n; i++) {
+    if (n == 0) {
+        auto& g = fonte.sintetico;
+        g.quantidade = ler_inteiro("Quantidade de requisicoes", 1, LLONG_MAX);
+        g.distintas = ler_inteiro("Paginas distintas", 1, PAGINA_MAXIMA + 1);
+        g.base = ler_inteiro("Pagina inicial", 0, PAGINA_MAXIMA + 1 - g.distintas);
+        g.pct_escrita = ler_inteiro("Percentual de escritas (0-100)", 0, 100);
+        g.gerador.seed((unsigned long long)ler_inteiro("Semente", 0, LLONG_MAX));
+        fonte.sintetica = true;
+        cout << "[OK] Sequencia sintetica de " << g.quantidade << " requisicoes (gerada durante a simulacao).\n";
+        return fonte;
+    }
+
+    cout << "(Use o sufixo W para escrita, ex.: 3W; sem sufixo ou R e leitura)\n";
+    for (long long i = 0; i < n; i++) {
         while (true) {
             cout << "Requisicao de pagina " << (i + 1) << ": ";
-            cin >> lista[i];
-            if (cin.fail() || lista[i] < 0) {
+            string token;
+            cin >> token;
+            if (cin.fail() || !interpretar_referencia(token, fonte.lista[i])) {
                 cin.clear();
-                cin.ignore(1000, '\n');
                 cout << "Valor invalido!\n";
                 continue;
             }
             break;
         }
     }
-    return lista;
+    return fonte;
 }
 
 AlgoritmoSubstituicao escolher_algoritmo_substituicao() {
@@ -489,164 +1046,735 @@ AlgoritmoSubstituicao escolher_algoritmo_substituicao() {
     }
 }
 
-void simular_paginacao() {
-    int num_frames;
-    while (true) {
-        cout << "Numero de frames na memoria: ";
-        cin >> num_frames;
-        if (cin.fail() || num_frames <= 0) {
-            cin.clear();
-            cin.ignore(1000, '\n');
-            cout << "Valor invalido!\n";
-            continue;
+int buscar_pagina_escalar(const long long* frames, int n, long long pagina) {
+    for (int i = 0; i < n; ++i) {
+        if (frames[i] == pagina) return i;
+    }
+    return -1;
+}
+
+int indice_menor_escalar(const long long* valores, int n) {
+    long long menor = LLONG_MAX;
+    int indice = -1;
+    for (int i = 0; i < n; ++i) {
+        if (valores[i] < menor) {
+            menor = valores[i];
+            indice = i;
         }
-        break;
     }
+    return indice;
+}
 
-    vector<int> requisicoes = ler_requisicoes();
-    AlgoritmoSubstituicao algoritmo = escolher_algoritmo_substituicao();
+// Sem min_epi64 antes do AVX-512: o minimo por faixa sai de cmpgt + blendv. Quatro acumuladores
+// independentes quebram a cadeia de dependencia entre passos; depois, a primeira ocorrencia do
+// minimo (o desempate do laco escalar) sai da busca, que tambem testa quatro vetores por passo.
+#ifdef SIMULADOR_SIMD_X86
+__attribute__((target("sse4.2")))
+int buscar_pagina_sse42(const long long* frames, int n, long long pagina) {
+    const __m128i alvo = _mm_set1_epi64x(pagina);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i* v = (const __m128i*)(frames + i);
+        __m128i c0 = _mm_cmpeq_epi64(_mm_loadu_si128(v), alvo);
+        __m128i c1 = _mm_cmpeq_epi64(_mm_loadu_si128(v + 1), alvo);
+        __m128i c2 = _mm_cmpeq_epi64(_mm_loadu_si128(v + 2), alvo);
+        __m128i c3 = _mm_cmpeq_epi64(_mm_loadu_si128(v + 3), alvo);
+        __m128i algum = _mm_or_si128(_mm_or_si128(c0, c1), _mm_or_si128(c2, c3));
+        if (!_mm_testz_si128(algum, algum)) {
+            int mascara = _mm_movemask_pd(_mm_castsi128_pd(c0)) | (_mm_movemask_pd(_mm_castsi128_pd(c1)) << 2)
+                        | (_mm_movemask_pd(_mm_castsi128_pd(c2)) << 4) | (_mm_movemask_pd(_mm_castsi128_pd(c3)) << 6);
+            return i + __builtin_ctz(mascara);
+        }
+    }
+    for (; i < n; ++i) {
+        if (frames[i] == pagina) return i;
+    }
+    return -1;
+}
 
-    cout << "\n===== Iniciando simulacao de paginacao =====\n";
+__attribute__((target("sse4.2")))
+int indice_menor_sse42(const long long* valores, int n) {
+    if (n < 8) return indice_menor_escalar(valores, n);
+    const __m128i* v = (const __m128i*)valores;
+    __m128i m0 = _mm_loadu_si128(v), m1 = _mm_loadu_si128(v + 1);
+    __m128i m2 = _mm_loadu_si128(v + 2), m3 = _mm_loadu_si128(v + 3);
+    int i = 8;
+    for (; i + 8 <= n; i += 8) {
+        v = (const __m128i*)(valores + i);
+        __m128i v0 = _mm_loadu_si128(v), v1 = _mm_loadu_si128(v + 1);
+        __m128i v2 = _mm_loadu_si128(v + 2), v3 = _mm_loadu_si128(v + 3);
+        m0 = _mm_blendv_epi8(m0, v0, _mm_cmpgt_epi64(m0, v0));
+        m1 = _mm_blendv_epi8(m1, v1, _mm_cmpgt_epi64(m1, v1));
+        m2 = _mm_blendv_epi8(m2, v2, _mm_cmpgt_epi64(m2, v2));
+        m3 = _mm_blendv_epi8(m3, v3, _mm_cmpgt_epi64(m3, v3));
+    }
+    m0 = _mm_blendv_epi8(m0, m1, _mm_cmpgt_epi64(m0, m1));
+    m2 = _mm_blendv_epi8(m2, m3, _mm_cmpgt_epi64(m2, m3));
+    m0 = _mm_blendv_epi8(m0, m2, _mm_cmpgt_epi64(m0, m2));
+    long long faixas[2];
+    _mm_storeu_si128((__m128i*)faixas, m0);
+    long long menor = min(faixas[0], faixas[1]);
+    for (; i < n; ++i) menor = min(menor, valores[i]);
+    return buscar_pagina_sse42(valores, n, menor);
+}
 
-    string seq_str;
-    for (size_t i = 0; i < requisicoes.size(); ++i) {
-        seq_str += to_string(requisicoes[i]);
-        if (i < requisicoes.size() - 1) seq_str += ", ";
+__attribute__((target("avx2")))
+int buscar_pagina_avx2(const long long* frames, int n, long long pagina) {
+    const __m256i alvo = _mm256_set1_epi64x(pagina);
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m256i* v = (const __m256i*)(frames + i);
+        __m256i c0 = _mm256_cmpeq_epi64(_mm256_loadu_si256(v), alvo);
+        __m256i c1 = _mm256_cmpeq_epi64(_mm256_loadu_si256(v + 1), alvo);
+        __m256i c2 = _mm256_cmpeq_epi64(_mm256_loadu_si256(v + 2), alvo);
+        __m256i c3 = _mm256_cmpeq_epi64(_mm256_loadu_si256(v + 3), alvo);
+        __m256i algum = _mm256_or_si256(_mm256_or_si256(c0, c1), _mm256_or_si256(c2, c3));
+        if (!_mm256_testz_si256(algum, algum)) {
+            int mascara = _mm256_movemask_pd(_mm256_castsi256_pd(c0)) | (_mm256_movemask_pd(_mm256_castsi256_pd(c1)) << 4)
+                        | (_mm256_movemask_pd(_mm256_castsi256_pd(c2)) << 8) | (_mm256_movemask_pd(_mm256_castsi256_pd(c3)) << 12);
+            return i + __builtin_ctz(mascara);
+        }
     }
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(frames + i));
+        int mascara = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, alvo)));
+        if (mascara) return i + __builtin_ctz(mascara);
+    }
+    for (; i < n; ++i) {
+        if (frames[i] == pagina) return i;
+    }
+    return -1;
+}
 
-    cout << "Numero de frames: " << num_frames << endl;
-    cout << "Sequencia de requisicoes: " << seq_str << endl;
-    cout << "Algoritmo: " << (algoritmo == FIFO ? "FIFO" : (algoritmo == LRU ? "LRU" : "Otimo")) << endl;
+__attribute__((target("avx2")))
+int indice_menor_avx2(const long long* valores, int n) {
+    if (n < 16) return indice_menor_escalar(valores, n);
+    const __m256i* v = (const __m256i*)valores;
+    __m256i m0 = _mm256_loadu_si256(v), m1 = _mm256_loadu_si256(v + 1);
+    __m256i m2 = _mm256_loadu_si256(v + 2), m3 = _mm256_loadu_si256(v + 3);
+    int i = 16;
+    for (; i + 16 <= n; i += 16) {
+        v = (const __m256i*)(valores + i);
+        __m256i v0 = _mm256_loadu_si256(v), v1 = _mm256_loadu_si256(v + 1);
+        __m256i v2 = _mm256_loadu_si256(v + 2), v3 = _mm256_loadu_si256(v + 3);
+        m0 = _mm256_blendv_epi8(m0, v0, _mm256_cmpgt_epi64(m0, v0));
+        m1 = _mm256_blendv_epi8(m1, v1, _mm256_cmpgt_epi64(m1, v1));
+        m2 = _mm256_blendv_epi8(m2, v2, _mm256_cmpgt_epi64(m2, v2));
+        m3 = _mm256_blendv_epi8(m3, v3, _mm256_cmpgt_epi64(m3, v3));
+    }
+    m0 = _mm256_blendv_epi8(m0, m1, _mm256_cmpgt_epi64(m0, m1));
+    m2 = _mm256_blendv_epi8(m2, m3, _mm256_cmpgt_epi64(m2, m3));
+    m0 = _mm256_blendv_epi8(m0, m2, _mm256_cmpgt_epi64(m0, m2));
+    long long faixas[4];
+    _mm256_storeu_si256((__m256i*)faixas, m0);
+    long long menor = min(min(faixas[0], faixas[1]), min(faixas[2], faixas[3]));
+    for (; i < n; ++i) menor = min(menor, valores[i]);
+    return buscar_pagina_avx2(valores, n, menor);
+}
+#endif
+
+// Melhor conjunto de instrucoes vetoriais suportado pela CPU em execucao.
+CaminhoBusca detectar_simd() {
+    static const CaminhoBusca detectado = []() {
+#ifdef SIMULADOR_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return BUSCA_AVX2;
+        if (__builtin_cpu_supports("sse4.2")) return BUSCA_SSE42;
+#endif
+        return BUSCA_ESCALAR;
+    }();
+    return detectado;
+}
 
-    cout << left << setw(6) << "Req";
-    for (int i = 0; i < num_frames; ++i) {
-        cout << setw(10) << ("F" + to_string(i));
+const char* nome_caminho_busca(CaminhoBusca caminho) {
+    switch (caminho) {
+        case BUSCA_SSE42: return "SSE4.2";
+        case BUSCA_AVX2:  return "AVX2";
+        case BUSCA_HASH:  return "Hash";
+        default:          return "Escalar";
     }
-    cout << setw(22) << "Evento" << "Page Faults" << endl;
-    cout << string(6 + num_frames * 10 + 22 + 11, '-') << endl;
+}
 
-    const string RED = "\033[31m";
-    const string GREEN = "\033[32m";
-    const string RESET = "\033[0m";
-    const int INF = 999999;
+CaminhoBusca selecionar_caminho_busca(int num_frames) {
+    if (num_frames >= g_limite_hash) return BUSCA_HASH;
+    if (num_frames >= g_limite_simd) return detectar_simd();
+    return BUSCA_ESCALAR;
+}
 
-    auto format_frame = [](int val, bool is_victim) -> string {
-        if (is_victim) {
-            return "[" + to_string(val) + "](X)";
-        } else if (val == -1) {
-            return "[ ]";
-        } else {
-            return "[" + to_string(val) + "]";
-        }
-    };
+// A varredura do LRU tem faixa propria: o kernel vetorial do minimo so compensa com mais frames.
+CaminhoBusca selecionar_caminho_lru(int num_frames) {
+    return num_frames >= g_limite_simd_lru ? detectar_simd() : BUSCA_ESCALAR;
+}
 
-    vector<int> frames(num_frames, -1);
-    vector<int> use_time(num_frames, 0);
-    queue<int> fifo_queue;
-    int tempo = 0;
-    int page_faults = 0;
+// O caminho hash nao tem busca linear; quem o usa consulta o indice pagina -> frame.
+int buscar_pagina(CaminhoBusca caminho, const long long* frames, int n, long long pagina) {
+#ifdef SIMULADOR_SIMD_X86
+    if (caminho == BUSCA_AVX2) return buscar_pagina_avx2(frames, n, pagina);
+    if (caminho == BUSCA_SSE42) return buscar_pagina_sse42(frames, n, pagina);
+#endif
+    (void)caminho;
+    return buscar_pagina_escalar(frames, n, pagina);
+}
 
-    for (size_t pos = 0; pos < requisicoes.size(); ++pos) {
-        int req = requisicoes[pos];
+int indice_menor(CaminhoBusca caminho, const long long* valores, int n) {
+#ifdef SIMULADOR_SIMD_X86
+    if (caminho == BUSCA_AVX2) return indice_menor_avx2(valores, n);
+    if (caminho == BUSCA_SSE42) return indice_menor_sse42(valores, n);
+#endif
+    return indice_menor_escalar(valores, n);
+}
 
-        int passo = esperar_passo();
-        if (passo == 0) {
-            cout << "\nSimulacao interrompida pelo usuario.\n";
-            break;
+PoliticaPrefetch escolher_politica_prefetch() {
+    int op;
+    while (true) {
+        cout << "\nEscolha a politica de prefetch (read-ahead):\n";
+        cout << "1 - Nenhuma\n";
+        cout << "2 - Sequencial (pagina seguinte)\n";
+        cout << "3 - Stride (passo constante entre requisicoes)\n";
+        cout << "Opcao: ";
+        cin >> op;
+        if (cin.fail()) {
+            cin.clear();
+            cin.ignore(1000, '\n');
+            cout << "Opcao invalida!\n";
+            continue;
         }
+        if (op >= 1 && op <= 3) return (PoliticaPrefetch)op;
+        cout << "Opcao invalida!\n";
+    }
+}
 
-        ++tempo;
-        bool fault = true;
-        int hit_idx = -1;
-        int empty_idx = -1;
+// Pagina a antecipar depois desta requisicao (-1 = nenhuma). O detector de stride e
+// treinado com toda requisicao da demanda, inclusive hits em paginas ja antecipadas;
+// quem chama so usa o alvo em faults e no primeiro uso de uma pagina antecipada.
+long long prever_prefetch(PoliticaPrefetch politica, long long pagina, long long& ultima_pagina, long long& ultimo_stride) {
+    long long alvo = -1;
+    if (politica == PREFETCH_SEQUENCIAL) {
+        if (pagina < LLONG_MAX) alvo = pagina + 1;
+    } else if (politica == PREFETCH_STRIDE) {
+        // Repetir a mesma pagina nao muda o padrao.
+        if (ultima_pagina != -1 && pagina != ultima_pagina) {
+            // Paginas sao nao negativas, entao a diferenca nunca transborda.
+            long long stride = pagina - ultima_pagina;
+            bool cabe = stride > 0 ? pagina <= LLONG_MAX - stride : pagina + stride >= 0;
+            if (stride == ultimo_stride && cabe) alvo = pagina + stride;
+            ultimo_stride = stride;
+        }
+        ultima_pagina = pagina;
+    }
+    return alvo;
+}
 
-        for (int i = 0; i < num_frames; ++i) {
-            if (frames[i] == req) {
-                fault = false;
-                hit_idx = i;
-                break;
+double ler_tempo(const string& rotulo, double atual) {
+    double valor;
+    while (true) {
+        cout << rotulo << " (us) [atual " << atual << "]: ";
+        cin >> valor;
+        if (cin.fail() || valor < 0) {
+            cin.clear();
+            cin.ignore(1000, '\n');
+            cout << "Valor invalido!\n";
+            continue;
+        }
+        return valor;
+    }
+}
+
+void configurar_modelo_custo() {
+    g_modelo_custo.tempo_hit = ler_tempo("Tempo de acesso com hit", g_modelo_custo.tempo_hit);
+    g_modelo_custo.tempo_fault = ler_tempo("Tempo de servico de page fault", g_modelo_custo.tempo_fault);
+    g_modelo_custo.tempo_writeback = ler_tempo("Tempo de write-back de pagina suja", g_modelo_custo.tempo_writeback);
+    g_modelo_custo.tempo_prefetch = ler_tempo("Tempo adicional por pagina de read-ahead", g_modelo_custo.tempo_prefetch);
+    cout << "[OK] Modelo de custo atualizado.\n";
+}
+
+// Motor usado pela simulacao: busca por caminho (escalar/SIMD/hash), LRU vetorizado
+// e Otimo pela proxima ocorrencia pre-indexada de cada requisicao. FIFO e LRU recebem
+// uma requisicao por vez e nao precisam do trace inteiro.
+struct MotorPaginacao {
+    int num_frames = 0;
+    AlgoritmoSubstituicao algoritmo = FIFO;
+    PoliticaPrefetch politica = PREFETCH_NENHUM;
+    CaminhoBusca caminho = BUSCA_ESCALAR;
+    CaminhoBusca caminho_lru = BUSCA_ESCALAR;
+
+    vector<long long> frames;
+    vector<long long> use_time;
+    vector<bool> sujo;
+    vector<bool> prefetched;
+    queue<int> fifo_queue;
+    unordered_map<long long, int> posicao;
+    // Otimo: proxima posicao com a mesma pagina de cada requisicao (total = nunca), em 32 bits
+    // quando o trace cabe, e a proxima ocorrencia ainda nao processada de cada pagina.
+    vector<uint32_t> proxima_curta;
+    vector<uint64_t> proxima_longa;
+    unordered_map<long long, uint64_t> proxima_ocorrencia;
+    uint64_t total_requisicoes = 0;
+    long long tempo = 0;
+    long long frames_livres = 0;
+    long long page_faults = 0, hits = 0, escritas = 0, writebacks = 0;
+    long long prefetches = 0, prefetches_uteis = 0;
+    long long ultima_pagina = -1, ultimo_stride = 0;
+
+    void iniciar(int n, AlgoritmoSubstituicao alg, PoliticaPrefetch pol, CaminhoBusca cam, CaminhoBusca cam_lru) {
+        *this = MotorPaginacao();
+        num_frames = n;
+        algoritmo = alg;
+        politica = pol;
+        caminho = cam;
+        caminho_lru = cam_lru;
+        frames.assign(n, -1);
+        use_time.assign(n, 0);
+        sujo.assign(n, false);
+        prefetched.assign(n, false);
+        frames_livres = n;
+    }
+
+    // Obrigatorio para o Otimo, antes da primeira requisicao: percorre o trace de tras para frente.
+    void indexar_futuro(const vector<Referencia>& reqs) {
+        total_requisicoes = reqs.size();
+        bool curta = total_requisicoes < UINT32_MAX;
+        if (curta) proxima_curta.resize(reqs.size());
+        else proxima_longa.resize(reqs.size());
+        for (size_t j = reqs.size(); j-- > 0;) {
+            auto it = proxima_ocorrencia.find(reqs[j].pagina());
+            uint64_t prox = it == proxima_ocorrencia.end() ? total_requisicoes : it->second;
+            if (curta) proxima_curta[j] = (uint32_t)prox;
+            else proxima_longa[j] = prox;
+            proxima_ocorrencia[reqs[j].pagina()] = j;
+        }
+    }
+
+    int localizar(long long pagina) {
+        if (caminho == BUSCA_HASH) {
+            g_contadores.frames_varridos++;
+            auto it = posicao.find(pagina);
+            return it == posicao.end() ? -1 : it->second;
+        }
+        int idx = buscar_pagina(caminho, frames.data(), num_frames, pagina);
+        g_contadores.frames_varridos += (idx == -1 ? num_frames : idx + 1);
+        return idx;
+    }
+
+    void ocupar_frame(int idx, long long pagina) {
+        if (caminho == BUSCA_HASH) {
+            if (frames[idx] != -1) posicao.erase(frames[idx]);
+            posicao[pagina] = idx;
+        }
+        frames[idx] = pagina;
+    }
+
+    int escolher_vitima(int protegido) {
+        int victim_idx = -1;
+        if (algoritmo == FIFO) {
+            g_contadores.iteracoes_busca_vitima++;
+            victim_idx = fifo_queue.front();
+            fifo_queue.pop();
+            if (victim_idx == protegido) {
+                // A pagina que disparou o read-ahead nao sai por ele: volta ao fim da fila.
+                fifo_queue.push(victim_idx);
+                victim_idx = fifo_queue.front();
+                fifo_queue.pop();
+            }
+        } else if (algoritmo == LRU) {
+            long long salvo = 0;
+            if (protegido != -1) {
+                salvo = use_time[protegido];
+                use_time[protegido] = LLONG_MAX;
+            }
+            victim_idx = indice_menor(caminho_lru, use_time.data(), num_frames);
+            if (protegido != -1) use_time[protegido] = salvo;
+            g_contadores.iteracoes_busca_vitima += num_frames;
+        } else if (algoritmo == OTIMO) {
+            // Sai a pagina de proximo uso mais distante; paginas sem uso futuro empatam em total_requisicoes.
+            uint64_t mais_distante = 0;
+            for (int i = 0; i < num_frames; ++i) {
+                if (i == protegido) continue;
+                g_contadores.iteracoes_busca_vitima++;
+                uint64_t prox = total_requisicoes;
+                auto it = proxima_ocorrencia.find(frames[i]);
+                if (it != proxima_ocorrencia.end()) prox = it->second;
+                if (victim_idx == -1 || prox > mais_distante) {
+                    mais_distante = prox;
+                    victim_idx = i;
+                }
             }
-            if (frames[i] == -1 && empty_idx == -1) empty_idx = i;
         }
+        return victim_idx;
+    }
 
-        if (!fault) {
+    // pos e a posicao de ref no trace; so o Otimo a usa.
+    EventoPaginacao processar(size_t pos, Referencia ref) {
+        EventoPaginacao ev;
+        long long req = ref.pagina();
+        bool escrita = ref.escrita();
+
+        ++tempo;
+        if (algoritmo == OTIMO) {
+            proxima_ocorrencia[req] = proxima_curta.empty() ? proxima_longa[pos] : proxima_curta[pos];
+        }
+        if (escrita) ++escritas;
+        long long alvo = prever_prefetch(politica, req, ultima_pagina, ultimo_stride);
+        // Frames nunca sao esvaziados, entao os livres sao sempre os ultimos.
+        int hit_idx = localizar(req);
+        if (hit_idx != -1) {
+            ++hits;
             if (algoritmo == LRU) use_time[hit_idx] = tempo;
-            string event = "Hit " + to_string(req);
-            cout << left << setw(6) << req;
-            for (int i = 0; i < num_frames; ++i) {
-                string content = format_frame(frames[i], false);
-                string color = (i == hit_idx ? GREEN : "");
-                if (!color.empty()) cout << color;
-                cout << left << setw(10) << content;
-                if (!color.empty()) cout << RESET;
+            if (escrita) sujo[hit_idx] = true;
+            ev.hit = true;
+            ev.frame = hit_idx;
+            // O primeiro uso de uma pagina antecipada confirma o fluxo e puxa a seguinte.
+            if (prefetched[hit_idx]) {
+                prefetched[hit_idx] = false;
+                ++prefetches_uteis;
+                antecipar(ev, alvo, hit_idx);
             }
-            cout << setw(22) << event << page_faults << endl;
-            continue;
+            return ev;
         }
 
-        int victim_idx = empty_idx;
-        bool is_replace = (empty_idx == -1);
+        int victim_idx = frames_livres > 0 ? (int)(num_frames - frames_livres) : -1;
+        if (victim_idx == -1) {
+            victim_idx = escolher_vitima(-1);
+            ev.removida = frames[victim_idx];
+            ev.writeback = sujo[victim_idx];
+            if (ev.writeback) ++writebacks;
+        } else {
+            frames_livres--;
+        }
+        ocupar_frame(victim_idx, req);
+        sujo[victim_idx] = escrita;
+        prefetched[victim_idx] = false;
+        if (algoritmo == FIFO) fifo_queue.push(victim_idx);
+        if (algoritmo == LRU) use_time[victim_idx] = tempo;
+        ++page_faults;
+        ev.frame = victim_idx;
+        antecipar(ev, alvo, victim_idx);
+        return ev;
+    }
 
-        if (is_replace) {
-            if (algoritmo == FIFO) {
+    // Traz a pagina prevista sem tirar da memoria a pagina da requisicao atual (protegido).
+    void antecipar(EventoPaginacao& ev, long long alvo, int protegido) {
+        if (alvo == -1 || num_frames <= 1 || localizar(alvo) != -1) return;
+        int destino = frames_livres > 0 ? (int)(num_frames - frames_livres) : -1;
+        if (destino == -1) {
+            destino = escolher_vitima(protegido);
+            ev.removida_prefetch = frames[destino];
+            ev.writeback_prefetch = sujo[destino];
+            if (ev.writeback_prefetch) ++writebacks;
+        } else {
+            frames_livres--;
+        }
+        ocupar_frame(destino, alvo);
+        sujo[destino] = false;
+        prefetched[destino] = true;
+        if (algoritmo == FIFO) fifo_queue.push(destino);
+        if (algoritmo == LRU) use_time[destino] = tempo;
+        ++prefetches;
+        ev.frame_prefetch = destino;
+        ev.pagina_prefetch = alvo;
+    }
+};
+
+// Implementacao direta, sem indices nem SIMD: varreduras lineares e busca futura
+// na sequencia, exatamente como a simulacao fazia originalmente. Serve de
+// referencia para o modo diferencial.
+struct MotorReferencia {
+    const vector<Referencia>* requisicoes = nullptr;
+    int num_frames = 0;
+    AlgoritmoSubstituicao algoritmo = FIFO;
+    PoliticaPrefetch politica = PREFETCH_NENHUM;
+
+    vector<long long> frames;
+    vector<long long> use_time;
+    vector<bool> sujo;
+    vector<bool> prefetched;
+    queue<int> fifo_queue;
+    long long tempo = 0;
+    long long page_faults = 0, writebacks = 0;
+    long long ultima_pagina = -1, ultimo_stride = 0;
+
+    void iniciar(const vector<Referencia>& reqs, int n, AlgoritmoSubstituicao alg, PoliticaPrefetch pol) {
+        *this = MotorReferencia();
+        requisicoes = &reqs;
+        num_frames = n;
+        algoritmo = alg;
+        politica = pol;
+        frames.assign(n, -1);
+        use_time.assign(n, 0);
+        sujo.assign(n, false);
+        prefetched.assign(n, false);
+    }
+
+    int escolher_vitima(size_t pos, int protegido) {
+        int victim_idx = -1;
+        if (algoritmo == FIFO) {
+            victim_idx = fifo_queue.front();
+            fifo_queue.pop();
+            if (victim_idx == protegido) {
+                fifo_queue.push(victim_idx);
                 victim_idx = fifo_queue.front();
                 fifo_queue.pop();
-            } else if (algoritmo == LRU) {
-                int min_t = INT_MAX;
-                for (int i = 0; i < num_frames; ++i) {
-                    if (use_time[i] < min_t) {
-                        min_t = use_time[i];
-                        victim_idx = i;
-                    }
+            }
+        } else if (algoritmo == LRU) {
+            long long min_t = LLONG_MAX;
+            for (int i = 0; i < num_frames; ++i) {
+                if (i != protegido && use_time[i] < min_t) {
+                    min_t = use_time[i];
+                    victim_idx = i;
                 }
-            } else if (algoritmo == OTIMO) {
-                int max_dist = -1;
-                for (int i = 0; i < num_frames; ++i) {
-                    int dist = INF;
-                    for (size_t j = pos + 1; j < requisicoes.size(); ++j) {
-                        if (requisicoes[j] == frames[i]) {
-                            dist = (int)(j - pos);
-                            break;
-                        }
-                    }
-                    if (dist > max_dist) {
-                        max_dist = dist;
-                        victim_idx = i;
+            }
+        } else if (algoritmo == OTIMO) {
+            const vector<Referencia>& reqs = *requisicoes;
+            size_t max_dist = 0;
+            for (int i = 0; i < num_frames; ++i) {
+                if (i == protegido) continue;
+                size_t dist = numeric_limits<size_t>::max();
+                for (size_t j = pos + 1; j < reqs.size(); ++j) {
+                    if (reqs[j].pagina() == frames[i]) {
+                        dist = j - pos;
+                        break;
                     }
                 }
+                if (victim_idx == -1 || dist > max_dist) {
+                    max_dist = dist;
+                    victim_idx = i;
+                }
             }
         }
+        return victim_idx;
+    }
 
-        if (is_replace) {
-            string event1 = "Substitui " + to_string(frames[victim_idx]) + "->" + to_string(req);
-            cout << left << setw(6) << req;
-            for (int i = 0; i < num_frames; ++i) {
-                string content = format_frame(frames[i], i == victim_idx);
-                string color = (i == victim_idx ? RED : "");
-                if (!color.empty()) cout << color;
-                cout << left << setw(10) << content;
-                if (!color.empty()) cout << RESET;
+    EventoPaginacao processar(size_t pos) {
+        EventoPaginacao ev;
+        long long req = (*requisicoes)[pos].pagina();
+        bool escrita = (*requisicoes)[pos].escrita();
+
+        ++tempo;
+        long long alvo = prever_prefetch(politica, req, ultima_pagina, ultimo_stride);
+        int hit_idx = -1;
+        int empty_idx = -1;
+        for (int i = 0; i < num_frames; ++i) {
+            if (frames[i] == req) {
+                hit_idx = i;
+                break;
             }
-            cout << setw(22) << event1 << page_faults + 1 << endl;
+            if (frames[i] == -1 && empty_idx == -1) empty_idx = i;
         }
 
+        if (hit_idx != -1) {
+            if (algoritmo == LRU) use_time[hit_idx] = tempo;
+            if (escrita) sujo[hit_idx] = true;
+            ev.hit = true;
+            ev.frame = hit_idx;
+            if (prefetched[hit_idx]) {
+                prefetched[hit_idx] = false;
+                antecipar(ev, pos, alvo, hit_idx);
+            }
+            return ev;
+        }
+
+        int victim_idx = empty_idx;
+        if (victim_idx == -1) {
+            victim_idx = escolher_vitima(pos, -1);
+            ev.removida = frames[victim_idx];
+            ev.writeback = sujo[victim_idx];
+            if (ev.writeback) ++writebacks;
+        }
         frames[victim_idx] = req;
+        sujo[victim_idx] = escrita;
+        prefetched[victim_idx] = false;
         if (algoritmo == FIFO) fifo_queue.push(victim_idx);
         if (algoritmo == LRU) use_time[victim_idx] = tempo;
-
         ++page_faults;
+        ev.frame = victim_idx;
+        antecipar(ev, pos, alvo, victim_idx);
+        return ev;
+    }
 
-        string event2 = is_replace ? "Apos troca" : "Carrega " + to_string(req);
+    void antecipar(EventoPaginacao& ev, size_t pos, long long alvo, int protegido) {
+        if (alvo == -1 || num_frames <= 1) return;
+        for (int i = 0; i < num_frames; ++i) {
+            if (frames[i] == alvo) return;
+        }
+        int destino = -1;
+        for (int i = 0; i < num_frames; ++i) {
+            if (frames[i] == -1) {
+                destino = i;
+                break;
+            }
+        }
+        if (destino == -1) {
+            destino = escolher_vitima(pos, protegido);
+            ev.removida_prefetch = frames[destino];
+            ev.writeback_prefetch = sujo[destino];
+            if (ev.writeback_prefetch) ++writebacks;
+        }
+        frames[destino] = alvo;
+        sujo[destino] = false;
+        prefetched[destino] = true;
+        if (algoritmo == FIFO) fifo_queue.push(destino);
+        if (algoritmo == LRU) use_time[destino] = tempo;
+        ev.frame_prefetch = destino;
+        ev.pagina_prefetch = alvo;
+    }
+};
+
+void simular_paginacao() {
+    int num_frames;
+    while (true) {
+        cout << "Numero de frames na memoria: ";
+        cin >> num_frames;
+        if (cin.fail() || num_frames <= 0) {
+            cin.clear();
+            cin.ignore(1000, '\n');
+            cout << "Valor invalido!\n";
+            continue;
+        }
+        break;
+    }
+
+    FonteRequisicoes fonte = ler_requisicoes();
+    AlgoritmoSubstituicao algoritmo = escolher_algoritmo_substituicao();
+    PoliticaPrefetch politica = escolher_politica_prefetch();
+    // So o Otimo olha o futuro; FIFO e LRU consomem a sequencia sintetica enquanto ela e gerada.
+    if (algoritmo == OTIMO && !materializar_requisicoes(fonte)) return;
+    const long long total = fonte.total();
+
+    cout << "\n===== Iniciando simulacao de paginacao =====\n";
+
+    const long long MAX_SEQ_EXIBIDA = 64;
+    string seq_str;
+    GeradorRequisicoes previa = fonte.sintetico;
+    for (long long i = 0; i < total && i < MAX_SEQ_EXIBIDA; ++i) {
+        seq_str += rotulo_referencia(fonte.sintetica ? previa.proxima() : fonte.lista[i]);
+        if (i < total - 1) seq_str += ", ";
+    }
+    if (total > MAX_SEQ_EXIBIDA) {
+        seq_str += "... (" + to_string(total) + " no total)";
+    }
+
+    cout << "Numero de frames: " << num_frames << endl;
+    cout << "Sequencia de requisicoes: " << seq_str << endl;
+    cout << "Algoritmo: " << (algoritmo == FIFO ? "FIFO" : (algoritmo == LRU ? "LRU" : "Otimo")) << endl;
+    CaminhoBusca caminho = selecionar_caminho_busca(num_frames);
+    CaminhoBusca caminho_lru = selecionar_caminho_lru(num_frames);
+    cout << "Busca de frames: " << nome_caminho_busca(caminho) << endl;
+    if (algoritmo == LRU) cout << "Varredura LRU: " << nome_caminho_busca(caminho_lru) << endl;
+    if (politica != PREFETCH_NENHUM) {
+        cout << "Prefetch: " << (politica == PREFETCH_SEQUENCIAL ? "Sequencial" : "Stride") << endl;
+    }
+
+    cout << left << setw(6) << "Req";
+    for (int i = 0; i < num_frames; ++i) {
+        cout << setw(10) << ("F" + to_string(i));
+    }
+    cout << setw(22) << "Evento" << "Page Faults" << endl;
+    cout << string(6 + num_frames * 10 + 22 + 11, '-') << endl;
+
+    const string RED = "\033[31m";
+    const string GREEN = "\033[32m";
+    const string RESET = "\033[0m";
+
+    g_contadores.zerar_paginacao();
+    MotorPaginacao motor;
+    motor.iniciar(num_frames, algoritmo, politica, caminho, caminho_lru);
+    if (algoritmo == OTIMO) {
+        try {
+            motor.indexar_futuro(fonte.lista);
+        } catch (const exception&) {
+            cout << "[FALHA] Memoria insuficiente para indexar o futuro da sequencia (Otimo).\n";
+            return;
+        }
+    }
+    bool exibir = true;
+
+    // Linhas da tabela: estado anterior, apos a carga e apos o prefetch.
+    vector<long long> frames_exibidos;
+    vector<bool> sujo_exibido;
+
+    auto imprimir_linha = [&](const string& req, int destaque, const string& color, bool marca_vitima,
+                              const string& event, long long faults) {
         cout << left << setw(6) << req;
         for (int i = 0; i < num_frames; ++i) {
-            string content = format_frame(frames[i], false);
-            string color = (i == victim_idx ? GREEN : "");
-            if (!color.empty()) cout << color;
+            string content = "[ ]";
+            if (frames_exibidos[i] != -1) {
+                content = "[" + to_string(frames_exibidos[i]) + "]" + (sujo_exibido[i] ? "*" : "");
+                if (marca_vitima && i == destaque) content += "(X)";
+            }
+            bool pinta = (i == destaque);
+            if (pinta) cout << color;
             cout << left << setw(10) << content;
-            if (!color.empty()) cout << RESET;
+            if (pinta) cout << RESET;
         }
-        cout << setw(22) << event2 << page_faults << endl;
+        cout << setw(22) << event << faults << endl;
+    };
+
+    // Se a serie contigua exporta para o mesmo arquivo, anexa em vez de truncar: a opcao 7 ainda vai continua-la.
+    bool preservar_contigua = g_simulacao_contigua_realizada && g_formato_metricas_contigua != METRICAS_DESATIVADAS
+                           && g_arquivo_metricas_contigua == g_arquivo_metricas;
+    JanelaMetricas janela;
+    iniciar_exportacao_metricas("paginacao", janela, g_formato_metricas, g_arquivo_metricas, preservar_contigua);
+
+    for (long long pos = 0; pos < total; ++pos) {
+        Referencia ref = fonte.sintetica ? fonte.sintetico.proxima() : fonte.lista[pos];
+        long long req = ref.pagina();
+        bool escrita = ref.escrita();
+
+        int passo = exibir ? esperar_passo() : 1;
+        if (passo == 0) {
+            cout << "\nSimulacao interrompida pelo usuario.\n";
+            break;
+        }
+        if (passo == 2) {
+            exibir = false;
+            cout << "[INFO] Executando ate o fim sem exibir a tabela passo a passo...\n";
+        }
+
+        if (exibir) {
+            frames_exibidos = motor.frames;
+            sujo_exibido = motor.sujo;
+        }
+        EventoPaginacao ev = motor.processar((size_t)pos, ref);
+
+        janela.eventos++;
+        if (!ev.hit) janela.page_faults++;
+        janela.writebacks += (ev.writeback ? 1 : 0) + (ev.writeback_prefetch ? 1 : 0);
+
+        if (exibir) {
+            string rotulo = rotulo_referencia(ref);
+            long long faults_antes = motor.page_faults - (ev.hit ? 0 : 1);
+            if (ev.hit) {
+                if (escrita) sujo_exibido[ev.frame] = true;
+                imprimir_linha(rotulo, ev.frame, GREEN, false, "Hit " + rotulo, motor.page_faults);
+            } else {
+                bool is_replace = (ev.removida != -1);
+                if (is_replace) {
+                    string event1 = "Substitui " + to_string(ev.removida) + "->" + to_string(req)
+                                  + (ev.writeback ? " +WB" : "");
+                    imprimir_linha(rotulo, ev.frame, RED, true, event1, faults_antes + 1);
+                }
+                frames_exibidos[ev.frame] = req;
+                sujo_exibido[ev.frame] = escrita;
+                string event2 = is_replace ? "Apos troca" : "Carrega " + to_string(req);
+                imprimir_linha(rotulo, ev.frame, GREEN, false, event2, motor.page_faults);
+            }
+
+            if (ev.frame_prefetch != -1) {
+                string event3 = "Prefetch " + to_string(ev.pagina_prefetch);
+                if (ev.removida_prefetch != -1) {
+                    event3 = "Prefetch " + to_string(ev.removida_prefetch) + "->" + to_string(ev.pagina_prefetch)
+                           + (ev.writeback_prefetch ? " +WB" : "");
+                }
+                frames_exibidos = motor.frames;
+                sujo_exibido = motor.sujo;
+                imprimir_linha(rotulo, ev.frame_prefetch, GREEN, false, event3, motor.page_faults);
+            }
+        }
+
+        if (janela.eventos == g_janela_metricas) fechar_janela_metricas(janela, motor.frames_livres, -1, -1, -1);
     }
+    fechar_janela_metricas(janela, motor.frames_livres, -1, -1, -1);
+    finalizar_exportacao_metricas();
 
     cout << "\nRepresentacao ASCII (frames) :\n";
     for (int i = 0; i < num_frames; ++i) {
@@ -654,34 +1782,494 @@ void simular_paginacao() {
     }
     cout << endl;
     for (int i = 0; i < num_frames; ++i) {
-        cout << (frames[i] == -1 ? "[ ]" : "[" + to_string(frames[i]) + "]") << " ";
+        cout << (motor.frames[i] == -1 ? "[ ]" : "[" + to_string(motor.frames[i]) + "]") << " ";
     }
     cout << endl;
 
-    if (!requisicoes.empty()) {
-        double fault_rate = static_cast<double>(page_faults) / requisicoes.size() * 100.0;
+    // Taxas e tempo efetivo sobre as requisicoes processadas: a simulacao pode ter sido interrompida.
+    const long long referencias = motor.tempo;
+    if (referencias > 0) {
+        long long page_faults = motor.page_faults;
+        double fault_rate = static_cast<double>(page_faults) / referencias * 100.0;
         double hit_rate = 100.0 - fault_rate;
+        const auto& c = g_modelo_custo;
+        double tempo_total = motor.hits * c.tempo_hit + page_faults * c.tempo_fault
+                           + motor.writebacks * c.tempo_writeback + motor.prefetches * c.tempo_prefetch;
+        double tempo_efetivo = tempo_total / referencias;
         cout << "\n===== Metricas Finais =====\n";
         cout << "Total de page faults: " << page_faults << "\n";
         cout << "Taxa de page faults: " << fixed << setprecision(2) << fault_rate << "%\n";
         cout << "Taxa de acertos: " << fixed << setprecision(2) << hit_rate << "%\n";
+        cout << "Escritas: " << motor.escritas << " | Write-backs: " << motor.writebacks << "\n";
+        if (politica != PREFETCH_NENHUM) {
+            cout << "Paginas antecipadas (prefetch): " << motor.prefetches
+                 << " | Usadas antes de sair: " << motor.prefetches_uteis << "\n";
+        }
+        cout << "Tempo efetivo de acesso: " << fixed << setprecision(2) << tempo_efetivo << " us\n";
 
         g_page_faults = page_faults;
         g_fault_rate = fault_rate;
         g_hit_rate = hit_rate;
+        g_writebacks = motor.writebacks;
+        g_tempo_efetivo = tempo_efetivo;
         g_ultima_simulacao = 2;
     }
 }
 
+void benchmark_busca_frames() {
+    const CaminhoBusca simd = detectar_simd();
+    const long long ELEMENTOS = 8000000;
+    const int AMOSTRAS = 7;
+    // Um caminho mais elaborado so e escolhido se for pelo menos 10% mais rapido.
+    const double MARGEM = 0.9;
+    mt19937 gerador(12345);
+    volatile long long sumidouro = 0;
+
+    // Menor de AMOSTRAS medicoes apos uma rodada de aquecimento (o minimo e o menos afetado por
+    // interferencia); preparar restaura o estado antes de cada uma.
+    auto medir = [&](auto&& preparar, auto&& operacao, int repeticoes) {
+        double menor = numeric_limits<double>::max();
+        for (int t = 0; t <= AMOSTRAS; ++t) {
+            preparar();
+            auto inicio = chrono::steady_clock::now();
+            long long soma = 0;
+            for (int r = 0; r < repeticoes; ++r) soma += operacao(r);
+            auto fim = chrono::steady_clock::now();
+            sumidouro = sumidouro + soma;
+            if (t > 0) menor = min(menor, chrono::duration<double, nano>(fim - inicio).count() / repeticoes);
+        }
+        return menor;
+    };
+
+    cout << "\nCPU: melhor caminho vetorial disponivel = " << nome_caminho_busca(simd) << "\n";
+    cout << left << setw(8) << "Frames" << setw(12) << "Escalar" << setw(12) << "SIMD" << setw(12) << "Hash"
+         << setw(12) << "Min esc." << setw(12) << "Min SIMD" << "Mais rapido (busca / LRU)" << "\n";
+    cout << string(92, '-') << "\n";
+
+    int novo_limite_simd = INT_MAX, novo_limite_hash = INT_MAX, novo_limite_lru = INT_MAX;
+    for (int n = 4; n <= 4096; n *= 2) {
+        vector<long long> frames_iniciais(n), use_time_iniciais(n);
+        for (int i = 0; i < n; ++i) {
+            frames_iniciais[i] = i * 2;
+            use_time_iniciais[i] = (long long)(gerador() % 1000000);
+        }
+        shuffle(frames_iniciais.begin(), frames_iniciais.end(), gerador);
+
+        // Metade das consultas acerta (paginas pares), metade erra (impares). Como no motor,
+        // cada erro carrega a pagina no proximo frame da fila; no hash isso inclui o erase/insert.
+        vector<long long> consultas(4096);
+        for (auto& c : consultas) c = (long long)(gerador() % (2 * n));
+        int repeticoes = (int)max(1000LL, ELEMENTOS / n);
+
+        vector<long long> frames, use_time;
+        unordered_map<long long, int> indice;
+        int vitima = 0;
+        auto preparar_frames = [&]() {
+            frames = frames_iniciais;
+            vitima = 0;
+        };
+        auto preparar_hash = [&]() {
+            preparar_frames();
+            indice.clear();
+            for (int i = 0; i < n; ++i) indice[frames[i]] = i;
+        };
+        auto preparar_lru = [&]() { use_time = use_time_iniciais; };
+        auto carregar = [&](long long pagina) {
+            frames[vitima] = pagina;
+            vitima = vitima + 1 == n ? 0 : vitima + 1;
+        };
+
+        double t_escalar = medir(preparar_frames, [&](int r) {
+            long long pagina = consultas[r & 4095];
+            int idx = buscar_pagina_escalar(frames.data(), n, pagina);
+            if (idx == -1) carregar(pagina);
+            return idx;
+        }, repeticoes);
+        double t_simd = medir(preparar_frames, [&](int r) {
+            long long pagina = consultas[r & 4095];
+            int idx = buscar_pagina(simd, frames.data(), n, pagina);
+            if (idx == -1) carregar(pagina);
+            return idx;
+        }, repeticoes);
+        double t_hash = medir(preparar_hash, [&](int r) {
+            long long pagina = consultas[r & 4095];
+            auto it = indice.find(pagina);
+            if (it != indice.end()) return it->second;
+            indice.erase(frames[vitima]);
+            indice[pagina] = vitima;
+            carregar(pagina);
+            return -1;
+        }, repeticoes);
+        // Como no LRU: o frame de menor use_time recebe o tempo mais recente.
+        double t_min_escalar = medir(preparar_lru, [&](int r) {
+            int idx = indice_menor_escalar(use_time.data(), n);
+            use_time[idx] = 1000000LL + r;
+            return idx;
+        }, repeticoes);
+        double t_min_simd = medir(preparar_lru, [&](int r) {
+            int idx = indice_menor(simd, use_time.data(), n);
+            use_time[idx] = 1000000LL + r;
+            return idx;
+        }, repeticoes);
+
+        CaminhoBusca vencedor = BUSCA_ESCALAR;
+        double melhor = t_escalar;
+        if (t_simd < melhor * MARGEM) { melhor = t_simd; vencedor = simd; }
+        if (t_hash < melhor * MARGEM) { melhor = t_hash; vencedor = BUSCA_HASH; }
+        CaminhoBusca vencedor_lru = t_min_simd < t_min_escalar * MARGEM ? simd : BUSCA_ESCALAR;
+
+        // Cada limite e o menor tamanho a partir do qual o caminho vence em todos os maiores.
+        if (vencedor == BUSCA_HASH) novo_limite_hash = min(novo_limite_hash, n);
+        else novo_limite_hash = INT_MAX;
+        if (vencedor != BUSCA_ESCALAR) novo_limite_simd = min(novo_limite_simd, n);
+        else novo_limite_simd = INT_MAX;
+        if (vencedor_lru != BUSCA_ESCALAR) novo_limite_lru = min(novo_limite_lru, n);
+        else novo_limite_lru = INT_MAX;
+
+        cout << fixed << setprecision(1) << left << setw(8) << n << setw(12) << t_escalar << setw(12) << t_simd
+             << setw(12) << t_hash << setw(12) << t_min_escalar << setw(12) << t_min_simd
+             << nome_caminho_busca(vencedor) << " / " << nome_caminho_busca(vencedor_lru) << "\n";
+    }
+    cout << "(tempos em ns por operacao: menor de " << AMOSTRAS << " amostras apos aquecimento; "
+            "erros de busca incluem a carga do frame)\n";
+
+    g_limite_simd = novo_limite_simd;
+    g_limite_hash = novo_limite_hash;
+    g_limite_simd_lru = novo_limite_lru;
+    // Limite INT_MAX = o caminho nao venceu no maior tamanho medido e fica desativado.
+    cout << "[OK] Selecao automatica da busca: ";
+    if (g_limite_simd == INT_MAX) {
+        cout << "escalar em todos os tamanhos (" << nome_caminho_busca(simd) << " e hash desativados).\n";
+    } else {
+        cout << "escalar abaixo de " << g_limite_simd << " frames, " << nome_caminho_busca(simd);
+        if (g_limite_simd == g_limite_hash) cout << " desativado";
+        else if (g_limite_hash == INT_MAX) cout << " a partir dai";
+        else cout << " abaixo de " << g_limite_hash;
+        cout << (g_limite_hash == INT_MAX ? ", hash desativado.\n" : ", hash a partir dai.\n");
+    }
+    cout << "[OK] Varredura do LRU: ";
+    if (g_limite_simd_lru == INT_MAX) {
+        cout << "escalar em todos os tamanhos (" << nome_caminho_busca(simd) << " desativado).\n";
+    } else {
+        cout << "escalar abaixo de " << g_limite_simd_lru << " frames, " << nome_caminho_busca(simd) << " a partir dai.\n";
+    }
+}
+
+bool eventos_iguais(const EventoPaginacao& a, const EventoPaginacao& b) {
+    return a.hit == b.hit && a.frame == b.frame && a.removida == b.removida && a.writeback == b.writeback
+        && a.frame_prefetch == b.frame_prefetch && a.pagina_prefetch == b.pagina_prefetch
+        && a.removida_prefetch == b.removida_prefetch && a.writeback_prefetch == b.writeback_prefetch;
+}
+
+string descrever_evento(const EventoPaginacao& ev) {
+    string s = ev.hit ? "hit no frame " + to_string(ev.frame) : "fault -> frame " + to_string(ev.frame);
+    if (ev.removida != -1) s += " (removeu " + to_string(ev.removida) + (ev.writeback ? ", write-back)" : ")");
+    if (ev.frame_prefetch != -1) {
+        s += "; prefetch " + to_string(ev.pagina_prefetch) + " -> frame " + to_string(ev.frame_prefetch);
+        if (ev.removida_prefetch != -1) {
+            s += " (removeu " + to_string(ev.removida_prefetch) + (ev.writeback_prefetch ? ", write-back)" : ")");
+        }
+    }
+    return s;
+}
+
+void imprimir_estado_frames(const string& rotulo, const vector<long long>& frames, const vector<bool>& sujo,
+                            const vector<long long>& use_time, queue<int> fifo_queue, long long tempo) {
+    cout << "  " << rotulo << " (tempo " << tempo << "):\n    frames:";
+    for (size_t i = 0; i < frames.size(); ++i) {
+        cout << " F" << i << "=" << (frames[i] == -1 ? string("-") : to_string(frames[i])) << (sujo[i] ? "*" : "");
+    }
+    cout << "\n    use_time:";
+    for (long long t : use_time) cout << " " << t;
+    cout << "\n    fila FIFO:";
+    while (!fifo_queue.empty()) {
+        cout << " F" << fifo_queue.front();
+        fifo_queue.pop();
+    }
+    cout << "\n";
+}
+
+const char* nome_algoritmo(AlgoritmoSubstituicao algoritmo) {
+    return algoritmo == FIFO ? "FIFO" : (algoritmo == LRU ? "LRU" : "Otimo");
+}
+
+const char* nome_politica(PoliticaPrefetch politica) {
+    return politica == PREFETCH_NENHUM ? "sem prefetch" : (politica == PREFETCH_SEQUENCIAL ? "sequencial" : "stride");
+}
+
+const char* nome_estrategia(Estrategia estrategia) {
+    return estrategia == FIRST_FIT ? "First Fit" : (estrategia == BEST_FIT ? "Best Fit" : "Worst Fit");
+}
+
+// Roda o motor de referencia e o otimizado lado a lado; para no primeiro evento divergente.
+bool comparar_paginacao(const vector<Referencia>& requisicoes, int num_frames, AlgoritmoSubstituicao algoritmo,
+                        PoliticaPrefetch politica, CaminhoBusca caminho, bool relatar) {
+    MotorReferencia referencia;
+    MotorPaginacao otimizado;
+    referencia.iniciar(requisicoes, num_frames, algoritmo, politica);
+    // Os caminhos vetoriais tambem exercitam o kernel vetorial do LRU; escalar e hash, o escalar.
+    CaminhoBusca caminho_lru = caminho == BUSCA_HASH ? BUSCA_ESCALAR : caminho;
+    otimizado.iniciar(num_frames, algoritmo, politica, caminho, caminho_lru);
+    if (algoritmo == OTIMO) otimizado.indexar_futuro(requisicoes);
+
+    for (size_t pos = 0; pos < requisicoes.size(); ++pos) {
+        EventoPaginacao esperado = referencia.processar(pos);
+        EventoPaginacao obtido = otimizado.processar(pos, requisicoes[pos]);
+        // Compara tambem o estado que decide as proximas vitimas (use_time no LRU, fila no FIFO):
+        // um timestamp errado ou uma fila reordenada aparece no passo em que surge, nao so na
+        // remocao que por acaso o expuser.
+        bool estado_igual = referencia.frames == otimizado.frames && referencia.sujo == otimizado.sujo
+                         && (algoritmo != LRU || referencia.use_time == otimizado.use_time)
+                         && (algoritmo != FIFO || referencia.fifo_queue == otimizado.fifo_queue);
+        if (eventos_iguais(esperado, obtido) && estado_igual) {
+            continue;
+        }
+        if (relatar) {
+            cout << "[DIVERGENCIA] Paginacao: " << num_frames << " frames, " << nome_algoritmo(algoritmo) << ", "
+                 << nome_politica(politica) << ", busca " << nome_caminho_busca(caminho) << "\n";
+            cout << "  Requisicao " << (pos + 1) << " de " << requisicoes.size() << ": "
+                 << rotulo_referencia(requisicoes[pos]) << "\n  Contexto:";
+            size_t inicio = pos >= 8 ? pos - 8 : 0;
+            for (size_t j = inicio; j < requisicoes.size() && j <= pos + 8; ++j) {
+                cout << (j == pos ? " [" : " ") << rotulo_referencia(requisicoes[j]) << (j == pos ? "]" : "");
+            }
+            cout << "\n  Referencia: " << descrever_evento(esperado) << "\n  Otimizado:  " << descrever_evento(obtido) << "\n";
+            if (eventos_iguais(esperado, obtido)) cout << "  (eventos iguais; o estado dos frames divergiu)\n";
+            imprimir_estado_frames("Estado da referencia", referencia.frames, referencia.sujo, referencia.use_time,
+                                   referencia.fifo_queue, referencia.tempo);
+            imprimir_estado_frames("Estado do otimizado", otimizado.frames, otimizado.sujo, otimizado.use_time,
+                                   otimizado.fifo_queue, otimizado.tempo);
+        }
+        return false;
+    }
+    return true;
+}
+
+struct OperacaoAlocacao {
+    bool liberar;
+    string nome;
+    long long tamanho;
+};
+
+void imprimir_segmentos(const string& rotulo, const vector<Segmento>& memoria) {
+    cout << "  " << rotulo << ":\n";
+    for (const auto& b : memoria) {
+        cout << "    " << right << setw(8) << formatar_endereco(b.inicio) << " | " << setw(10) << formatar_tamanho(b.tamanho)
+             << " | " << (b.livre ? "LIVRE" : "Processo: " + b.processo) << "\n";
+    }
+}
+
+bool segmentos_iguais(const vector<Segmento>& a, const vector<Segmento>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].inicio != b[i].inicio || a[i].tamanho != b[i].tamanho || a[i].livre != b[i].livre
+            || a[i].processo != b[i].processo) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Aplica a mesma carga com a escolha linear original (escolher_segmento) e com o caminho
+// da simulacao (alocar_em_buraco sobre o IndiceBuracos), conferindo tambem o indice.
+bool comparar_alocacao(const vector<Segmento>& inicial, const vector<OperacaoAlocacao>& operacoes,
+                       Estrategia estrategia, bool relatar) {
+    vector<Segmento> mem_referencia = inicial, mem_indexada = inicial;
+    IndiceBuracos buracos;
+    buracos.reconstruir(mem_indexada);
+
+    for (size_t k = 0; k < operacoes.size(); ++k) {
+        const auto& op = operacoes[k];
+        long long esperado = -1, obtido = -1;
+        long long tamanho = alinhar_acima(op.tamanho, g_alinhamento);
+
+        if (op.liberar) {
+            liberar_processo(mem_referencia, op.nome);
+            liberar_processo(mem_indexada, op.nome, &buracos);
+        } else {
+            int i_ref = escolher_segmento(mem_referencia, tamanho, estrategia);
+            if (i_ref == -1 && existe_buracos_adjacentes(mem_referencia)) {
+                coalescer_buracos(mem_referencia);
+                i_ref = escolher_segmento(mem_referencia, tamanho, estrategia);
+            }
+            if (i_ref != -1) esperado = mem_referencia[ocupar_segmento(mem_referencia, i_ref, op.nome, tamanho)].inicio;
+
+            bool coalesceu;
+            int i_idx = alocar_em_buraco(mem_indexada, buracos, op.nome, tamanho, estrategia, coalesceu);
+            if (i_idx != -1) obtido = mem_indexada[i_idx].inicio;
+        }
+
+        IndiceBuracos reconstruido;
+        reconstruido.reconstruir(mem_indexada);
+        bool indice_ok = reconstruido.por_inicio == buracos.por_inicio && reconstruido.por_tamanho == buracos.por_tamanho;
+        if (esperado == obtido && segmentos_iguais(mem_referencia, mem_indexada) && indice_ok) continue;
+        if (relatar) {
+            cout << "[DIVERGENCIA] Alocacao contigua: " << nome_estrategia(estrategia) << ", alinhamento "
+                 << g_alinhamento << " B\n";
+            cout << "  Operacao " << (k + 1) << " de " << operacoes.size() << ": "
+                 << (op.liberar ? "liberar " + op.nome : "alocar " + op.nome + " (" + formatar_tamanho(op.tamanho) + ")")
+                 << "\n";
+            cout << "  Referencia alocou em: " << (esperado == -1 ? string("nenhum buraco") : formatar_endereco(esperado))
+                 << " | Indexado alocou em: " << (obtido == -1 ? string("nenhum buraco") : formatar_endereco(obtido)) << "\n";
+            imprimir_segmentos("Memoria da referencia", mem_referencia);
+            imprimir_segmentos("Memoria indexada", mem_indexada);
+            if (!indice_ok) {
+                cout << "  Indice de buracos desatualizado:";
+                for (const auto& b : buracos.por_inicio) {
+                    cout << " " << formatar_endereco(b.first) << "+" << formatar_tamanho(b.second);
+                }
+                cout << "\n";
+            }
+        }
+        return false;
+    }
+    return true;
+}
+
+vector<CaminhoBusca> caminhos_disponiveis() {
+    vector<CaminhoBusca> caminhos = {BUSCA_ESCALAR};
+#ifdef SIMULADOR_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) caminhos.push_back(BUSCA_SSE42);
+    if (__builtin_cpu_supports("avx2")) caminhos.push_back(BUSCA_AVX2);
+#endif
+    caminhos.push_back(BUSCA_HASH);
+    return caminhos;
+}
+
+struct LeitorBytes {
+    const uint8_t* dados;
+    size_t tamanho;
+    size_t pos = 0;
+
+    bool vazio() const { return pos >= tamanho; }
+    uint8_t proximo() { return pos < tamanho ? dados[pos++] : 0; }
+};
+
+// Um caso do modo diferencial decodificado de bytes arbitrarios. E o alvo do fuzzer
+// (SIMULADOR_FUZZ) e tambem o que a opcao do menu roda com bytes aleatorios.
+bool executar_caso_diferencial(const uint8_t* dados, size_t tamanho, bool relatar) {
+    LeitorBytes leitor{dados, tamanho};
+    ContadoresInstrumentacao contadores_salvos = g_contadores;
+    long long alinhamento_salvo = g_alinhamento;
+    bool ok = true;
+
+    if (leitor.proximo() % 2 == 0) {
+        int num_frames = 1 + leitor.proximo() % 12;
+        AlgoritmoSubstituicao algoritmo = (AlgoritmoSubstituicao)(1 + leitor.proximo() % 3);
+        PoliticaPrefetch politica = (PoliticaPrefetch)(1 + leitor.proximo() % 3);
+        uint8_t faixa = 1 + leitor.proximo() % 64;
+        vector<Referencia> requisicoes;
+        while (!leitor.vazio()) {
+            uint8_t b = leitor.proximo();
+            requisicoes.push_back(Referencia((long long)((b & 0x7F) % faixa), (b & 0x80) != 0));
+        }
+        for (CaminhoBusca caminho : caminhos_disponiveis()) {
+            if (!comparar_paginacao(requisicoes, num_frames, algoritmo, politica, caminho, relatar)) {
+                ok = false;
+                break;
+            }
+        }
+    } else {
+        Estrategia estrategia = (Estrategia)(1 + leitor.proximo() % 3);
+        g_alinhamento = 1LL << (leitor.proximo() % 8);
+        int particoes = 1 + leitor.proximo() % 8;
+        vector<Segmento> inicial;
+        long long endereco = 0;
+        for (int i = 0; i < particoes; ++i) {
+            long long tam = 1 + leitor.proximo() * 16LL;
+            inicial.push_back({endereco, tam, true, false, false, ""});
+            endereco += tam;
+        }
+        vector<OperacaoAlocacao> operacoes;
+        int criados = 0;
+        while (!leitor.vazio()) {
+            uint8_t b = leitor.proximo();
+            if ((b & 0x03) == 0 && criados > 0) {
+                operacoes.push_back({true, "P" + to_string(leitor.proximo() % criados), 0});
+            } else {
+                operacoes.push_back({false, "P" + to_string(criados++), 1 + (b >> 2) * 24LL});
+            }
+        }
+        ok = comparar_alocacao(inicial, operacoes, estrategia, relatar);
+    }
+
+    g_alinhamento = alinhamento_salvo;
+    g_contadores = contadores_salvos;
+    return ok;
+}
+
+void executar_validacao_diferencial() {
+    int op;
+    while (true) {
+        cout << "\nModo de validacao diferencial (referencia x motores otimizados):\n";
+        cout << "1 - Casos aleatorios (paginacao e alocacao)\n";
+        cout << "2 - Sequencia de paginas informada ou sintetica\n";
+        cout << "Opcao: ";
+        cin >> op;
+        if (cin.fail() || op < 1 || op > 2) {
+            cin.clear();
+            cin.ignore(1000, '\n');
+            cout << "Opcao invalida!\n";
+            continue;
+        }
+        break;
+    }
+
+    if (op == 1) {
+        long long casos = ler_inteiro("Quantidade de casos", 1, LLONG_MAX);
+        long long semente = ler_inteiro("Semente", 0, LLONG_MAX);
+        for (long long c = 0; c < casos; ++c) {
+            mt19937_64 gerador((unsigned long long)(semente + c));
+            vector<uint8_t> bytes(8 + gerador() % 512);
+            for (auto& b : bytes) b = (uint8_t)gerador();
+            if (!executar_caso_diferencial(bytes.data(), bytes.size(), true)) {
+                cout << "[FALHA] Caso " << (c + 1) << " (semente " << (semente + c) << ") divergiu da referencia.\n";
+                return;
+            }
+        }
+        cout << "[OK] " << casos << " casos aleatorios sem divergencia.\n";
+        return;
+    }
+
+    int num_frames = (int)ler_inteiro("Numero de frames na memoria", 1, INT_MAX);
+    FonteRequisicoes fonte = ler_requisicoes();
+    if (!materializar_requisicoes(fonte)) return;
+    const vector<Referencia>& requisicoes = fonte.lista;
+    ContadoresInstrumentacao contadores_salvos = g_contadores;
+    long long comparacoes = 0;
+    for (int a = FIFO; a <= OTIMO; ++a) {
+        for (int p = PREFETCH_NENHUM; p <= PREFETCH_STRIDE; ++p) {
+            for (CaminhoBusca caminho : caminhos_disponiveis()) {
+                if (!comparar_paginacao(requisicoes, num_frames, (AlgoritmoSubstituicao)a, (PoliticaPrefetch)p,
+                                        caminho, true)) {
+                    g_contadores = contadores_salvos;
+                    return;
+                }
+                comparacoes++;
+            }
+        }
+    }
+    g_contadores = contadores_salvos;
+    cout << "[OK] " << comparacoes << " combinacoes (algoritmo x prefetch x busca) identicas a referencia.\n";
+}
+
 void resetar_alocacao_contigua() {
     g_processos_carregados.clear();
     g_memoria.clear();
+    g_buracos.reconstruir(g_memoria);
     g_tamanho_memoria_carregado = 0;
     g_simulacao_contigua_realizada = false;
+    g_proxima_janela_contigua = 0;
+    g_formato_metricas_contigua = METRICAS_DESATIVADAS;
+    g_arquivo_metricas_contigua.clear();
     g_ultima_simulacao = 0; 
     g_page_faults = 0;
     g_fault_rate = 0.0;
     g_hit_rate = 0.0;
+    g_writebacks = 0;
+    g_tempo_efetivo = 0.0;
+    g_contadores = ContadoresInstrumentacao();
     cout << "Simulacao resetada com sucesso.\n\n";
 }
 
@@ -699,11 +2287,23 @@ void apresentacao_menu() {
     cout << "5 - Compactar memoria\n";
     cout << "6 - Mostrar mapa/estatisticas\n";
     cout << "7 - Adicionar processos (alocacao contigua)\n";
+    cout << "8 - Configurar exportacao de metricas (CSV/JSON Lines)\n";
+    cout << "9 - Configurar modelo de custo (paginacao)\n";
+    cout << "10 - Benchmark da busca de frames (escalar/SIMD/hash)\n";
+    cout << "11 - Configurar alinhamento (alocacao contigua)\n";
+    cout << "12 - Validacao diferencial (referencia x motores otimizados)\n";
     cout << "0 - Sair" << endl;
     cout << "------------------------------" << endl;
     cout << "> Escolha uma opcao: ";
 }
 
+#ifdef SIMULADOR_FUZZ
+// clang++ -std=c++17 -g -O1 -fsanitize=fuzzer,address -DSIMULADOR_FUZZ main.cpp -o fuzz_diferencial
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* dados, size_t tamanho) {
+    if (!executar_caso_diferencial(dados, tamanho, true)) abort();
+    return 0;
+}
+#else
 int main() {
     int opcao;
 
@@ -764,9 +2364,35 @@ int main() {
                 adicionar_processos_contigua();
                 break;
 
+            case 8:
+                cout << "\n[Exportacao de Metricas]\n";
+                configurar_exportacao_metricas();
+                break;
+
+            case 9:
+                cout << "\n[Modelo de Custo da Paginacao]\n";
+                configurar_modelo_custo();
+                break;
+
+            case 10:
+                cout << "\n[Benchmark da Busca de Frames]\n";
+                benchmark_busca_frames();
+                break;
+
+            case 11:
+                cout << "\n[Alinhamento da Alocacao Contigua]\n";
+                configurar_alinhamento();
+                break;
+
+            case 12:
+                cout << "\n[Validacao Diferencial]\n";
+                executar_validacao_diferencial();
+                break;
+
             default:
-                cout << "\nOpcao invalida! Escolha um valor entre 0 e 7.\n\n";
+                cout << "\nOpcao invalida! Escolha um valor entre 0 e 12.\n\n";
                 break;
         }
     }
-}
\ No newline at end of file
+}
+#endif